@@ -0,0 +1,186 @@
+#ifndef AISDI_LINEAR_BENCHMARK_H
+#define AISDI_LINEAR_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace aisdi
+{
+namespace benchmark
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the compiler from discarding a value computed only for timing.
+template <typename Type>
+inline void doNotOptimize(const Type& value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct Statistics
+{
+  double mean;
+  double min;
+  double p50;
+  double p90;
+  double p99;
+
+  static Statistics of(std::vector<double> samples)
+  {
+    Statistics result = {0, 0, 0, 0, 0};
+    if (samples.empty()) return result;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double sample : samples)
+      sum += sample;
+    auto percentile = [&samples](double p) {
+      return samples[static_cast<std::size_t>(p * (samples.size() - 1) + 0.5)];
+    };
+    result.mean = sum / samples.size();
+    result.min = samples.front();
+    result.p50 = percentile(0.50);
+    result.p90 = percentile(0.90);
+    result.p99 = percentile(0.99);
+    return result;
+  }
+};
+
+// Runs setup() untimed and body() timed, `samples` times. Each sample is
+// reported in nanoseconds per operation, body() performing `operations` of them.
+template <typename Setup, typename Body>
+Statistics measure(std::size_t samples, std::size_t operations, Setup setup, Body body)
+{
+  std::vector<double> results;
+  results.reserve(samples);
+  for (std::size_t i = 0; i < samples; ++i)
+  {
+    setup();
+    auto start = Clock::now();
+    body();
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    results.push_back(static_cast<double>(elapsed.count()) / (operations == 0 ? 1 : operations));
+  }
+  return Statistics::of(results);
+}
+
+// Peak resident set size since the last resetPeakRss(), in kilobytes, or -1
+// where /proc/self/status has no VmHWM. getrusage's ru_maxrss cannot be used:
+// it never goes down, so every row would carry the largest one before it.
+inline long peakRssKb()
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line))
+    if (line.compare(0, 6, "VmHWM:") == 0) return std::atol(line.c_str() + 6);
+  return -1;
+}
+
+// Lowers the peak to the current resident set size (Linux 4.0 and later).
+inline void resetPeakRss()
+{
+  std::ofstream clearRefs("/proc/self/clear_refs");
+  clearRefs << "5";
+}
+
+struct Result
+{
+  std::string suite;
+  std::string container;
+  std::string element;
+  std::string scenario;
+  std::size_t size;
+  Statistics nsPerOp;
+  double bytesPerItem; // negative when not measured
+  long peakRssKb; // while measuring this row only
+};
+
+class Report
+{
+public:
+  enum class Format { Text, Csv, Json };
+
+private:
+  std::vector<Result> results;
+
+  static std::string quoted(const std::string& text)
+  {
+    std::string result = "\"";
+    for (char c : text)
+    {
+      if (c == '"' || c == '\\') result += '\\';
+      result += c;
+    }
+    return result + "\"";
+  }
+
+public:
+  Report()
+  {
+    resetPeakRss();
+  }
+
+  void add(const std::string& suite, const std::string& container, const std::string& element,
+           const std::string& scenario, std::size_t size, const Statistics& nsPerOp,
+           double bytesPerItem = -1)
+  {
+    results.push_back(Result{suite, container, element, scenario, size, nsPerOp, bytesPerItem, peakRssKb()});
+    resetPeakRss();
+  }
+
+  const std::vector<Result>& getResults() const
+  {
+    return results;
+  }
+
+  void print(std::ostream& out, Format format) const
+  {
+    if (format == Format::Csv)
+    {
+      out << "suite,container,element,scenario,size,mean_ns,min_ns,p50_ns,p90_ns,p99_ns,bytes_per_item,peak_rss_kb\n";
+      for (const Result& r : results)
+        out << r.suite << ',' << quoted(r.container) << ',' << quoted(r.element) << ',' << r.scenario << ','
+            << r.size << ',' << r.nsPerOp.mean << ',' << r.nsPerOp.min << ',' << r.nsPerOp.p50 << ','
+            << r.nsPerOp.p90 << ',' << r.nsPerOp.p99 << ',' << r.bytesPerItem << ',' << r.peakRssKb << '\n';
+    }
+    else if (format == Format::Json)
+    {
+      out << "[\n";
+      for (std::size_t i = 0; i < results.size(); ++i)
+      {
+        const Result& r = results[i];
+        out << "  {\"suite\": " << quoted(r.suite) << ", \"container\": " << quoted(r.container)
+            << ", \"element\": " << quoted(r.element) << ", \"scenario\": " << quoted(r.scenario)
+            << ", \"size\": " << r.size << ", \"mean_ns\": " << r.nsPerOp.mean
+            << ", \"min_ns\": " << r.nsPerOp.min << ", \"p50_ns\": " << r.nsPerOp.p50
+            << ", \"p90_ns\": " << r.nsPerOp.p90 << ", \"p99_ns\": " << r.nsPerOp.p99;
+        if (r.bytesPerItem >= 0) out << ", \"bytes_per_item\": " << r.bytesPerItem;
+        out << ", \"peak_rss_kb\": " << r.peakRssKb << (i + 1 < results.size() ? "},\n" : "}\n");
+      }
+      out << "]\n";
+    }
+    else
+    {
+      for (const Result& r : results)
+      {
+        out << std::left << std::setw(12) << r.suite << std::setw(36) << r.container
+            << std::setw(22) << r.element << std::setw(14) << r.scenario << std::right
+            << std::setw(9) << r.size << std::fixed << std::setprecision(2)
+            << std::setw(12) << r.nsPerOp.p50 << " ns/op (p90 " << r.nsPerOp.p90 << ")";
+        if (r.bytesPerItem >= 0) out << "  " << r.bytesPerItem << " B/item";
+        out << '\n' << std::defaultfloat;
+      }
+    }
+  }
+};
+
+}
+}
+#endif // AISDI_LINEAR_BENCHMARK_H
@@ -0,0 +1,30 @@
+#ifndef AISDI_LINEAR_CHECKING_H
+#define AISDI_LINEAR_CHECKING_H
+
+namespace aisdi
+{
+
+// Iterator checking policies. With CheckedIterators every iterator move and
+// dereference is range checked and throws std::out_of_range; with
+// UncheckedIterators the checks are compiled out, leaving tight loops free
+// to be inlined and vectorized.
+
+struct CheckedIterators
+{
+  static constexpr bool enabled = true;
+};
+
+struct UncheckedIterators
+{
+  static constexpr bool enabled = false;
+};
+
+// Debug builds check, release (NDEBUG) builds do not.
+#ifdef NDEBUG
+using DefaultChecking = UncheckedIterators;
+#else
+using DefaultChecking = CheckedIterators;
+#endif
+
+}
+#endif // AISDI_LINEAR_CHECKING_H
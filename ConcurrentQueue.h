@@ -0,0 +1,374 @@
+#ifndef AISDI_LINEAR_CONCURRENTQUEUE_H
+#define AISDI_LINEAR_CONCURRENTQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include "Memory.h"
+#include "NodePool.h"
+
+namespace aisdi
+{
+
+// Lock-free multi-producer, multi-consumer FIFO queue (Michael & Scott).
+// Items live in singly linked nodes, as in LinkedList, behind a dummy node
+// that head always points to; a pop moves the value out of the node after
+// the dummy, which then becomes the new dummy. Nodes come from the heap and
+// are reclaimed with hazard pointers, so a node is freed only once no thread
+// can still be reading it. With a capacity, tryPush fails while the queue is
+// full; without one it fails only if allocation throws.
+//
+// The value's move assignment, used by tryPop, should not throw: the item is
+// already taken out of the queue by then.
+template <typename Type>
+class ConcurrentQueue
+{
+public:
+  using size_type = std::size_t;
+  using value_type = Type;
+  using reference = Type&;
+  using const_reference = const Type&;
+
+  static constexpr size_type unbounded = static_cast<size_type>(-1);
+
+private:
+  class Item
+  {
+    public:
+      std::atomic<Item*> next;
+      Item* retiredNext; // retired list of the hazard record that retired it
+      alignas(Type) unsigned char storage[sizeof(Type)]; // empty in the dummy
+
+      Item()
+        : next(nullptr), retiredNext(nullptr)
+      {}
+
+      Type* value()
+      {
+        return reinterpret_cast<Type*>(storage);
+      }
+  };
+
+  // Hazard pointers of one thread for the duration of one operation, plus
+  // the nodes it retired and could not free yet. Records are never freed
+  // before the queue, so the list of them only grows, to the largest number
+  // of threads that were inside the queue at the same time.
+  struct alignas(cacheLineSize) HazardRecord
+  {
+    std::atomic<Item*> hazards[2];
+    std::atomic<bool> active;
+    HazardRecord* nextRecord;
+    Item* retired;
+    size_type retiredCount;
+
+    HazardRecord()
+      : hazards{ { nullptr }, { nullptr } }, active(true), nextRecord(nullptr), retired(nullptr), retiredCount(0)
+    {}
+  };
+
+  class HazardGuard;
+
+  alignas(cacheLineSize) std::atomic<Item*> head;
+  alignas(cacheLineSize) std::atomic<Item*> tail;
+  alignas(cacheLineSize) std::atomic<size_type> n;
+  std::atomic<HazardRecord*> records;
+  std::atomic<size_type> recordCount;
+  const size_type limit;
+  const std::uint64_t id; // tells queues apart in the thread local record cache
+  HeapNodeAllocator<Item> allocator;
+
+  HazardRecord* acquireRecord();
+  static Item* protect(HazardRecord* record, int slot, const std::atomic<Item*>& source);
+  void retire(HazardRecord* record, Item* node);
+  void scan(HazardRecord* record);
+  template <typename... Args>
+  bool push(Args&&... args);
+
+public:
+  explicit ConcurrentQueue(size_type capacity = unbounded);
+  ConcurrentQueue(const ConcurrentQueue&) = delete;
+  ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+  ~ConcurrentQueue(); //no other thread may be using the queue any more
+
+  bool tryPush(const Type& item);
+  bool tryPush(Type&& item);
+  template <typename... Args>
+  bool tryEmplace(Args&&... args);
+  bool tryPop(Type& item); //false when the queue is empty
+
+  // exact only while no other thread pushes or pops
+  size_type getSize() const
+  {
+    return n.load(std::memory_order_relaxed);
+  }
+
+  bool isEmpty() const
+  {
+    return getSize() == 0;
+  }
+
+  size_type capacity() const
+  {
+    return limit;
+  }
+};
+
+template <typename Type>
+class ConcurrentQueue<Type>::HazardGuard
+{
+public:
+  HazardRecord* record;
+
+  explicit HazardGuard(HazardRecord* r)
+    : record(r)
+  {}
+
+  HazardGuard(const HazardGuard&) = delete;
+  HazardGuard& operator=(const HazardGuard&) = delete;
+
+  ~HazardGuard()
+  {
+    record->hazards[0].store(nullptr, std::memory_order_release);
+    record->hazards[1].store(nullptr, std::memory_order_release);
+    record->active.store(false, std::memory_order_release);
+  }
+};
+
+template <typename Type>
+ConcurrentQueue<Type> :: ConcurrentQueue(size_type capacity)
+    : head(nullptr), tail(nullptr), n(0), records(nullptr), recordCount(0), limit(capacity),
+      id([] {
+          static std::atomic<std::uint64_t> queues{0};
+          return ++queues;
+      }())
+{
+    Item* dummy = new (allocator.allocate()) Item();
+    head.store(dummy, std::memory_order_relaxed);
+    tail.store(dummy, std::memory_order_relaxed);
+}
+
+template <typename Type>
+ConcurrentQueue<Type> :: ~ConcurrentQueue()
+{
+    Item* node = head.load(std::memory_order_relaxed);
+    Item* next = node->next.load(std::memory_order_relaxed);
+    node->~Item();
+    allocator.deallocate(node);
+    for (node = next; node != nullptr; node = next)
+    {
+        next = node->next.load(std::memory_order_relaxed);
+        node->value()->~Type();
+        node->~Item();
+        allocator.deallocate(node);
+    }
+    HazardRecord* record = records.load(std::memory_order_relaxed);
+    while (record != nullptr)
+    {
+        for (Item* retired = record->retired; retired != nullptr; retired = next)
+        {
+            next = retired->retiredNext;
+            retired->~Item();
+            allocator.deallocate(retired);
+        }
+        HazardRecord* nextRecord = record->nextRecord;
+        delete record;
+        record = nextRecord;
+    }
+}
+
+// A thread first retries the record it used last time on this queue, so in
+// the common case taking a record is a single uncontended exchange.
+template <typename Type>
+typename ConcurrentQueue<Type>::HazardRecord* ConcurrentQueue<Type> :: acquireRecord()
+{
+    struct Cache
+    {
+      std::uint64_t owner;
+      HazardRecord* record;
+    };
+    static thread_local Cache cache = { 0, nullptr };
+
+    if (cache.owner == id && !cache.record->active.exchange(true, std::memory_order_acquire))
+        return cache.record;
+    for (HazardRecord* record = records.load(std::memory_order_acquire); record != nullptr; record = record->nextRecord)
+        if (!record->active.load(std::memory_order_relaxed) && !record->active.exchange(true, std::memory_order_acquire))
+        {
+            cache = { id, record };
+            return record;
+        }
+
+    HazardRecord* record = new HazardRecord();
+    record->nextRecord = records.load(std::memory_order_relaxed);
+    while (!records.compare_exchange_weak(record->nextRecord, record, std::memory_order_release, std::memory_order_relaxed))
+        ;
+    recordCount.fetch_add(1, std::memory_order_relaxed);
+    cache = { id, record };
+    return record;
+}
+
+// Publishes the node source points to as hazardous, and makes sure source
+// still pointed to it afterwards, so it cannot have been retired in between.
+template <typename Type>
+typename ConcurrentQueue<Type>::Item* ConcurrentQueue<Type> :: protect(HazardRecord* record, int slot,
+                                                                       const std::atomic<Item*>& source)
+{
+    Item* node = source.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        record->hazards[slot].store(node, std::memory_order_seq_cst);
+        Item* current = source.load(std::memory_order_seq_cst);
+        if (current == node) return node;
+        node = current;
+    }
+}
+
+template <typename Type>
+void ConcurrentQueue<Type> :: retire(HazardRecord* record, Item* node)
+{
+    node->retiredNext = record->retired;
+    record->retired = node;
+    if (++record->retiredCount >= 4 * recordCount.load(std::memory_order_relaxed) + 16) scan(record);
+}
+
+// Frees the retired nodes no record holds a hazard pointer to. The scan
+// threshold grows with the number of records, so that each scan frees at
+// least half of what it looks at and the cost per retired node stays
+// proportional to the number of threads.
+template <typename Type>
+void ConcurrentQueue<Type> :: scan(HazardRecord* record)
+{
+    Item* keep = nullptr;
+    size_type kept = 0;
+    Item* next;
+    for (Item* node = record->retired; node != nullptr; node = next)
+    {
+        next = node->retiredNext;
+        bool hazardous = false;
+        for (HazardRecord* other = records.load(std::memory_order_acquire); other != nullptr && !hazardous;
+             other = other->nextRecord)
+            hazardous = other->hazards[0].load(std::memory_order_seq_cst) == node ||
+                        other->hazards[1].load(std::memory_order_seq_cst) == node;
+        if (hazardous)
+        {
+            node->retiredNext = keep;
+            keep = node;
+            kept++;
+        }
+        else
+        {
+            node->~Item();
+            allocator.deallocate(node);
+        }
+    }
+    record->retired = keep;
+    record->retiredCount = kept;
+}
+
+template <typename Type>
+template <typename... Args>
+bool ConcurrentQueue<Type> :: push(Args&&... args)
+{
+    if (n.fetch_add(1, std::memory_order_relaxed) >= limit)
+    {
+        n.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    Item* node;
+    try
+    {
+        node = new (allocator.allocate()) Item();
+        try
+        {
+            new (node->storage) Type(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            node->~Item();
+            allocator.deallocate(node);
+            throw;
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        n.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    catch (...)
+    {
+        n.fetch_sub(1, std::memory_order_relaxed);
+        throw;
+    }
+
+    HazardGuard guard(acquireRecord());
+    for (;;)
+    {
+        Item* last = protect(guard.record, 0, tail);
+        Item* next = last->next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            // tail lags behind, help the other push along
+            tail.compare_exchange_weak(last, next, std::memory_order_release, std::memory_order_relaxed);
+            continue;
+        }
+        if (last->next.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed))
+        {
+            tail.compare_exchange_strong(last, node, std::memory_order_release, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+template <typename Type>
+bool ConcurrentQueue<Type> :: tryPush(const Type& item)
+{
+    return push(item);
+}
+
+template <typename Type>
+bool ConcurrentQueue<Type> :: tryPush(Type&& item)
+{
+    return push(std::move(item));
+}
+
+template <typename Type>
+template <typename... Args>
+bool ConcurrentQueue<Type> :: tryEmplace(Args&&... args)
+{
+    return push(std::forward<Args>(args)...);
+}
+
+// next is protected too: it cannot be retired before head moves past first,
+// and head still pointed to first after the hazard pointer to next was set.
+template <typename Type>
+bool ConcurrentQueue<Type> :: tryPop(Type& item)
+{
+    HazardGuard guard(acquireRecord());
+    for (;;)
+    {
+        Item* first = protect(guard.record, 0, head);
+        Item* next = first->next.load(std::memory_order_acquire);
+        guard.record->hazards[1].store(next, std::memory_order_seq_cst);
+        if (head.load(std::memory_order_seq_cst) != first) continue;
+        if (next == nullptr) return false;
+
+        Item* last = tail.load(std::memory_order_acquire);
+        if (first == last)
+        {
+            tail.compare_exchange_weak(last, next, std::memory_order_release, std::memory_order_relaxed);
+            continue;
+        }
+        if (head.compare_exchange_strong(first, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            item = std::move(*next->value());
+            next->value()->~Type();
+            n.fetch_sub(1, std::memory_order_relaxed);
+            retire(guard.record, first);
+            return true;
+        }
+    }
+}
+
+}
+#endif // AISDI_LINEAR_CONCURRENTQUEUE_H
@@ -0,0 +1,113 @@
+#include <ConcurrentQueue.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+// The multithreaded tests are meant to be run under ThreadSanitizer as well
+// (-fsanitize=thread), which checks the memory orderings and reclamation.
+
+BOOST_AUTO_TEST_SUITE(ConcurrentQueueTests)
+
+BOOST_AUTO_TEST_CASE(GivenEmptyQueue_WhenPopping_ThenNothingIsReturned)
+{
+  aisdi::ConcurrentQueue<int> queue;
+  int item = 7;
+
+  BOOST_CHECK(queue.isEmpty());
+  BOOST_CHECK(!queue.tryPop(item));
+  BOOST_CHECK_EQUAL(item, 7);
+}
+
+BOOST_AUTO_TEST_CASE(GivenQueue_WhenPushingAndPopping_ThenItemsComeOutInOrder)
+{
+  aisdi::ConcurrentQueue<std::string> queue;
+  queue.tryPush("a");
+  std::string b = "b";
+  queue.tryPush(b);
+  queue.tryEmplace(2, 'c');
+
+  std::string item;
+  BOOST_CHECK_EQUAL(queue.getSize(), 3);
+  BOOST_CHECK(queue.tryPop(item));
+  BOOST_CHECK_EQUAL(item, "a");
+  BOOST_CHECK(queue.tryPop(item));
+  BOOST_CHECK_EQUAL(item, "b");
+  BOOST_CHECK(queue.tryPop(item));
+  BOOST_CHECK_EQUAL(item, "cc");
+  BOOST_CHECK(!queue.tryPop(item));
+}
+
+BOOST_AUTO_TEST_CASE(GivenBoundedQueue_WhenItIsFull_ThenPushFails)
+{
+  aisdi::ConcurrentQueue<int> queue(2);
+  int item;
+
+  BOOST_CHECK(queue.tryPush(1));
+  BOOST_CHECK(queue.tryPush(2));
+  BOOST_CHECK(!queue.tryPush(3));
+  BOOST_CHECK(queue.tryPop(item));
+  BOOST_CHECK(queue.tryPush(4));
+  BOOST_CHECK_EQUAL(queue.getSize(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(GivenQueueDestroyedWithItems_WhenDestroyed_ThenItemsAreReleased)
+{
+  auto counter = std::make_shared<int>(0);
+  {
+    aisdi::ConcurrentQueue<std::shared_ptr<int>> queue;
+    for (int i = 0; i < 100; ++i) queue.tryPush(counter);
+    std::shared_ptr<int> item;
+    for (int i = 0; i < 40; ++i) queue.tryPop(item);
+    BOOST_CHECK_EQUAL(counter.use_count(), 62);
+  }
+  BOOST_CHECK_EQUAL(counter.use_count(), 1);
+}
+
+// Every producer pushes its own increasing sequence; each consumer has to see
+// every producer's items in order, and all of them have to come out once.
+BOOST_AUTO_TEST_CASE(GivenManyProducersAndConsumers_WhenRunningConcurrently_ThenEveryItemIsPoppedOnceInOrder)
+{
+  const int producers = 4, consumers = 4, perProducer = 20000;
+  aisdi::ConcurrentQueue<std::uint64_t> queue;
+  std::atomic<int> popped{0};
+  std::vector<std::vector<int>> seen(consumers, std::vector<int>(producers, -1));
+  std::vector<std::uint64_t> sums(consumers, 0);
+  std::atomic<bool> ordered{true};
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p)
+    threads.emplace_back([&, p] {
+      for (int i = 0; i < perProducer; ++i)
+        while (!queue.tryPush(std::uint64_t(p) << 32 | std::uint64_t(i)))
+          ;
+    });
+  for (int c = 0; c < consumers; ++c)
+    threads.emplace_back([&, c] {
+      std::uint64_t item;
+      while (popped.load() < producers * perProducer)
+        if (queue.tryPop(item))
+        {
+          popped++;
+          const int producer = int(item >> 32), index = int(item & 0xffffffff);
+          if (index <= seen[c][producer]) ordered = false;
+          seen[c][producer] = index;
+          sums[c] += std::uint64_t(index);
+        }
+    });
+  for (auto& thread : threads) thread.join();
+
+  std::uint64_t total = 0;
+  for (auto sum : sums) total += sum;
+  BOOST_CHECK(ordered.load());
+  BOOST_CHECK_EQUAL(total, std::uint64_t(producers) * perProducer * (perProducer - 1) / 2);
+  BOOST_CHECK(queue.isEmpty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,207 @@
+#ifndef AISDI_LINEAR_CONCURRENTVECTOR_H
+#define AISDI_LINEAR_CONCURRENTVECTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include "Memory.h"
+
+namespace aisdi
+{
+
+// Append-only vector that any number of threads may append to and index at
+// the same time. Items live in a chain of blocks of 64, 128, 256, ... slots,
+// so the block and slot of index i follow from the highest bit of i + 64,
+// and a block is never moved or freed before the vector: the address of an
+// item stays valid for the vector's whole life.
+//
+// append reserves its index with one fetch_add, allocates the block when it
+// is the first to need it (threads racing for a new block each allocate one,
+// the losers free theirs), constructs the item and sets its bit in the
+// block's ready bitmap. getSize counts only the items up to the first one
+// still being constructed, so every index below it may be read at once;
+// whichever thread finishes the item the count waits for moves it past all
+// the ready items after it.
+//
+// If constructing an item throws, its slot never becomes ready, and the
+// items appended after it are stored but never counted by getSize.
+template <typename Type>
+class ConcurrentVector
+{
+public:
+  using size_type = std::size_t;
+  using value_type = Type;
+  using reference = Type&;
+  using const_reference = const Type&;
+
+  static constexpr size_type firstBlockSize = 64;
+
+private:
+  static constexpr size_type firstBlockShift = 6;
+  static constexpr size_type blockCount = 64 - firstBlockShift;
+
+  std::atomic<Type*> blocks[blockCount];
+  std::atomic<std::atomic<std::uint64_t>*> readyBits[blockCount]; // one bit per slot
+  alignas(cacheLineSize) std::atomic<size_type> reserved;
+  alignas(cacheLineSize) std::atomic<size_type> published;
+
+  static size_type blockOf(size_type i)
+  {
+    return 63 - firstBlockShift - __builtin_clzll(static_cast<unsigned long long>(i) + firstBlockSize);
+  }
+
+  static size_type offsetIn(size_type i, size_type block)
+  {
+    return i + firstBlockSize - (firstBlockSize << block);
+  }
+
+  static size_type blockSize(size_type block)
+  {
+    return firstBlockSize << block;
+  }
+
+  Type* acquireBlock(size_type block);
+  void publish();
+
+public:
+  ConcurrentVector();
+  ConcurrentVector(const ConcurrentVector&) = delete;
+  ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+  ~ConcurrentVector(); //no other thread may be using the vector any more
+
+  // return the index the item went to
+  size_type append(const Type& item);
+  size_type append(Type&& item);
+  template <typename... Args>
+  size_type emplaceAppend(Args&&... args);
+
+  // i < getSize(), as seen by the calling thread
+  reference operator[](size_type i)
+  {
+    const size_type block = blockOf(i);
+    return blocks[block].load(std::memory_order_acquire)[offsetIn(i, block)];
+  }
+
+  const_reference operator[](size_type i) const
+  {
+    const size_type block = blockOf(i);
+    return blocks[block].load(std::memory_order_acquire)[offsetIn(i, block)];
+  }
+
+  // items that are fully constructed and readable
+  size_type getSize() const
+  {
+    return published.load(std::memory_order_acquire);
+  }
+
+  bool isEmpty() const
+  {
+    return getSize() == 0;
+  }
+};
+
+template <typename Type>
+ConcurrentVector<Type> :: ConcurrentVector()
+    : reserved(0), published(0)
+{
+    for (size_type block = 0; block < blockCount; block++)
+    {
+        blocks[block].store(nullptr, std::memory_order_relaxed);
+        readyBits[block].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template <typename Type>
+ConcurrentVector<Type> :: ~ConcurrentVector()
+{
+    const size_type n = reserved.load(std::memory_order_relaxed);
+    for (size_type block = 0; block < blockCount; block++)
+    {
+        Type* items = blocks[block].load(std::memory_order_relaxed);
+        std::atomic<std::uint64_t>* bits = readyBits[block].load(std::memory_order_relaxed);
+        if (items != nullptr)
+        {
+            const size_type first = blockSize(block) - firstBlockSize;
+            for (size_type offset = 0; offset < blockSize(block) && first + offset < n; offset++)
+                if (bits[offset / 64].load(std::memory_order_relaxed) >> offset % 64 & 1)
+                    items[offset].~Type();
+            deallocateStorage(items);
+        }
+        delete[] bits;
+    }
+}
+
+// The bitmap is installed before the items, so a block whose items are
+// visible always has its bitmap.
+template <typename Type>
+Type* ConcurrentVector<Type> :: acquireBlock(size_type block)
+{
+    Type* items = blocks[block].load(std::memory_order_acquire);
+    if (items != nullptr) return items;
+
+    if (readyBits[block].load(std::memory_order_acquire) == nullptr)
+    {
+        std::atomic<std::uint64_t>* bits = new std::atomic<std::uint64_t>[blockSize(block) / 64]();
+        std::atomic<std::uint64_t>* expected = nullptr;
+        if (!readyBits[block].compare_exchange_strong(expected, bits, std::memory_order_acq_rel))
+            delete[] bits;
+    }
+    Type* fresh = allocateStorage<Type>(blockSize(block));
+    if (blocks[block].compare_exchange_strong(items, fresh, std::memory_order_acq_rel))
+        return fresh;
+    deallocateStorage(fresh);
+    return items;
+}
+
+// Moves published past the ready items that follow it, a bitmap word at a
+// time. A thread that sets a bit and then finds published short of it can
+// leave: the bit and published are both seq_cst, so the thread that moves
+// published up to the bit is bound to see it.
+template <typename Type>
+void ConcurrentVector<Type> :: publish()
+{
+    size_type p = published.load(std::memory_order_seq_cst);
+    for (;;)
+    {
+        const size_type block = blockOf(p);
+        std::atomic<std::uint64_t>* bits = readyBits[block].load(std::memory_order_acquire);
+        if (bits == nullptr) return;
+        const size_type offset = offsetIn(p, block);
+        const std::uint64_t word = bits[offset / 64].load(std::memory_order_seq_cst) >> offset % 64;
+        if ((word & 1) == 0) return;
+        const size_type ready = ~word == 0 ? 64 : __builtin_ctzll(~word);
+        if (published.compare_exchange_weak(p, p + ready, std::memory_order_seq_cst))
+            p += ready;
+    }
+}
+
+template <typename Type>
+template <typename... Args>
+typename ConcurrentVector<Type>::size_type ConcurrentVector<Type> :: emplaceAppend(Args&&... args)
+{
+    const size_type i = reserved.fetch_add(1, std::memory_order_relaxed);
+    const size_type block = blockOf(i);
+    const size_type offset = offsetIn(i, block);
+    new (&acquireBlock(block)[offset]) Type(std::forward<Args>(args)...);
+    readyBits[block].load(std::memory_order_acquire)[offset / 64].fetch_or(std::uint64_t(1) << offset % 64,
+                                                                           std::memory_order_seq_cst);
+    publish();
+    return i;
+}
+
+template <typename Type>
+typename ConcurrentVector<Type>::size_type ConcurrentVector<Type> :: append(const Type& item)
+{
+    return emplaceAppend(item);
+}
+
+template <typename Type>
+typename ConcurrentVector<Type>::size_type ConcurrentVector<Type> :: append(Type&& item)
+{
+    return emplaceAppend(std::move(item));
+}
+
+}
+#endif // AISDI_LINEAR_CONCURRENTVECTOR_H
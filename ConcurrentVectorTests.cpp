@@ -0,0 +1,156 @@
+#include <ConcurrentVector.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+// The multithreaded test is meant to be run under ThreadSanitizer as well
+// (-fsanitize=thread), which checks block installation and publishing.
+
+namespace
+{
+
+// Counts live objects; the constructor from an int throws for throwAt.
+struct Tracked
+{
+  static int live;
+  static int throwAt;
+
+  int value;
+
+  explicit Tracked(int v) : value(v)
+  {
+    if (v == throwAt) throw std::runtime_error("failed");
+    ++live;
+  }
+
+  Tracked(const Tracked& other) : value(other.value) { ++live; }
+  ~Tracked() { --live; }
+};
+
+int Tracked::live = 0;
+int Tracked::throwAt = -1;
+
+}
+
+BOOST_AUTO_TEST_SUITE(ConcurrentVectorTests)
+
+BOOST_AUTO_TEST_CASE(GivenEmptyVector_WhenCreated_ThenItHasNoItems)
+{
+  aisdi::ConcurrentVector<int> vector;
+
+  BOOST_CHECK(vector.isEmpty());
+  BOOST_CHECK_EQUAL(vector.getSize(), 0);
+}
+
+// Blocks hold 64, 128, 256, ... items, so they start at 0, 64, 192, 448, 960.
+BOOST_AUTO_TEST_CASE(GivenItemsAcrossBlockBoundaries_WhenIndexing_ThenEachIsWhereItWasAppended)
+{
+  aisdi::ConcurrentVector<std::uint64_t> vector;
+  for (std::uint64_t i = 0; i < 2000; ++i)
+    BOOST_CHECK_EQUAL(vector.append(i * 3), i);
+
+  BOOST_CHECK_EQUAL(vector.getSize(), 2000);
+  for (std::size_t i : { 0, 63, 64, 127, 128, 191, 192, 255, 256, 447, 448, 959, 960, 1999 })
+    BOOST_CHECK_EQUAL(vector[i], i * 3);
+  const std::size_t blockStarts[] = { 0, 64, 192, 448, 960, 1984 };
+  for (std::size_t block = 0; block + 1 < 6; ++block)
+  {
+    const std::size_t first = blockStarts[block], last = blockStarts[block + 1] - 1;
+    BOOST_CHECK_EQUAL(&vector[last] - &vector[first], static_cast<std::ptrdiff_t>(last - first));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(GivenAddressOfItem_WhenVectorGrows_ThenAddressStaysValid)
+{
+  aisdi::ConcurrentVector<std::string> vector;
+  vector.append("first");
+  vector.emplaceAppend(3, 'x');
+  const std::string* first = &vector[0];
+  const std::string* second = &vector[1];
+
+  for (int i = 0; i < 10000; ++i) vector.append(std::to_string(i));
+
+  BOOST_CHECK_EQUAL(&vector[0], first);
+  BOOST_CHECK_EQUAL(&vector[1], second);
+  BOOST_CHECK_EQUAL(*first, "first");
+  BOOST_CHECK_EQUAL(*second, "xxx");
+  BOOST_CHECK_EQUAL(vector[10001], "9999");
+}
+
+BOOST_AUTO_TEST_CASE(GivenConstructorThrows_WhenAppendingMore_ThenSizeStopsBeforeTheFailedItem)
+{
+  Tracked::live = 0;
+  Tracked::throwAt = 70;
+  {
+    aisdi::ConcurrentVector<Tracked> vector;
+    for (int i = 0; i < 70; ++i) vector.emplaceAppend(i);
+    BOOST_CHECK_THROW(vector.emplaceAppend(70), std::runtime_error);
+    for (int i = 71; i < 100; ++i) vector.emplaceAppend(i);
+
+    BOOST_CHECK_EQUAL(vector.getSize(), 70);
+    BOOST_CHECK_EQUAL(vector[69].value, 69);
+    BOOST_CHECK_EQUAL(Tracked::live, 99);
+  }
+  // the failed slot is skipped, every constructed item is destroyed once
+  BOOST_CHECK_EQUAL(Tracked::live, 0);
+  Tracked::throwAt = -1;
+}
+
+BOOST_AUTO_TEST_CASE(GivenVectorDestroyedWithItems_WhenDestroyed_ThenItemsAreReleased)
+{
+  auto counter = std::make_shared<int>(0);
+  {
+    aisdi::ConcurrentVector<std::shared_ptr<int>> vector;
+    for (int i = 0; i < 500; ++i) vector.append(counter);
+    BOOST_CHECK_EQUAL(counter.use_count(), 501);
+  }
+  BOOST_CHECK_EQUAL(counter.use_count(), 1);
+}
+
+// Producers append their own sequences while a reader keeps checking every
+// item below getSize; afterwards each producer's items have to be where
+// append said they went.
+BOOST_AUTO_TEST_CASE(GivenProducersAndReader_WhenRunningConcurrently_ThenEveryPublishedItemIsComplete)
+{
+  const int producers = 4, perProducer = 20000;
+  aisdi::ConcurrentVector<std::uint64_t> vector;
+  std::vector<std::vector<std::size_t>> indices(producers);
+  std::atomic<int> finished{0};
+  std::atomic<bool> valid{true};
+
+  std::thread reader([&] {
+    std::size_t checked = 0;
+    while (finished.load() < producers || checked < vector.getSize())
+    {
+      const std::size_t size = vector.getSize();
+      for (; checked < size; ++checked)
+        if ((vector[checked] >> 32) >= std::uint64_t(producers)) valid = false;
+      std::this_thread::yield();
+    }
+  });
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p)
+    threads.emplace_back([&, p] {
+      for (int i = 0; i < perProducer; ++i)
+        indices[p].push_back(vector.append(std::uint64_t(p) << 32 | std::uint64_t(i)));
+      finished++;
+    });
+  for (auto& thread : threads) thread.join();
+  reader.join();
+
+  BOOST_CHECK(valid.load());
+  BOOST_CHECK_EQUAL(vector.getSize(), std::size_t(producers) * perProducer);
+  for (int p = 0; p < producers; ++p)
+    for (int i = 0; i < perProducer; ++i)
+      BOOST_REQUIRE_EQUAL(vector[indices[p][i]], std::uint64_t(p) << 32 | std::uint64_t(i));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
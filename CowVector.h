@@ -0,0 +1,333 @@
+#ifndef AISDI_LINEAR_COWVECTOR_H
+#define AISDI_LINEAR_COWVECTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include "Vector.h"
+
+namespace aisdi
+{
+
+// Copy-on-write Vector: copies share one reference counted Vector, so a copy
+// (a snapshot) costs one atomic increment whatever the size. The first
+// change made through a copy that is not the only owner detaches it onto a
+// private deep copy; changes are append, prepend, insert, erase, pop and
+// anything handing out a non-const reference (operator[], begin, end).
+//
+// A non-const reference or iterator lets its holder change the items later,
+// behind any copy made in the meantime, so once one has been handed out the
+// items are marked unshareable and every later copy is a deep one (as the
+// copy-on-write strings of old libstdc++ did). Write through set and read
+// through the const accessors to keep copies O(1).
+//
+// The count is atomic, so snapshots may be taken on one thread and read or
+// dropped on others. Each CowVector object itself is used by one thread at a
+// time, like any Vector. References and iterators obtained from a copy stay
+// valid while that copy holds on to the shared Vector, i.e. until it is
+// detached, changed or destroyed.
+template <typename Type, class Instrumentation = NoInstrumentation, class Checking = DefaultChecking>
+class CowVector
+{
+public:
+  using Items = Vector<Type, Instrumentation, Checking>;
+  using difference_type = typename Items::difference_type;
+  using size_type = typename Items::size_type;
+  using value_type = Type;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+  using iterator = typename Items::iterator;
+  using const_iterator = typename Items::const_iterator;
+
+private:
+  struct Shared
+  {
+    std::atomic<size_type> references;
+    bool unshareable; //a mutable reference into items was handed out
+    Items items;
+
+    explicit Shared(Items&& other)
+      : references(1), unshareable(false), items(std::move(other))
+    {}
+
+    explicit Shared(const Items& other)
+      : references(1), unshareable(false), items(other)
+    {}
+  };
+
+  Shared* shared; //null while empty and never changed
+
+  static const Items& emptyItems()
+  {
+    static const Items empty;
+    return empty;
+  }
+
+  void release();
+  Items& detach(); //makes this the only owner and returns its items
+  Items& leak(); //detaches for good: the items may now change behind any copy
+
+public:
+  CowVector();
+  CowVector(std::initializer_list<Type> l);
+  explicit CowVector(Items items);
+  CowVector(const CowVector& other); //O(1), shares other's items
+  CowVector(CowVector&& other);
+  ~CowVector();
+
+  CowVector& operator=(CowVector other);
+  void swapVectors(CowVector& x, CowVector& y);
+
+  const Items& items() const
+  {
+    return shared == nullptr ? emptyItems() : shared->items;
+  }
+
+  // whether another copy holds the same items, i.e. whether a change copies them
+  bool isShared() const
+  {
+    return shared != nullptr && shared->references.load(std::memory_order_acquire) > 1;
+  }
+
+  const_reference operator[](size_type i) const
+  {
+    return items().data()[i];
+  }
+
+  reference operator[](size_type i)
+  {
+    return leak().data()[i];
+  }
+
+  void set(size_type i, const Type& item)
+  {
+    detach().data()[i] = item;
+  }
+
+  void set(size_type i, Type&& item)
+  {
+    detach().data()[i] = std::move(item);
+  }
+
+  const_pointer data() const
+  {
+    return items().data();
+  }
+
+  Span<const Type> asSpan() const
+  {
+    return items().asSpan();
+  }
+
+  bool isEmpty() const
+  {
+    return items().isEmpty();
+  }
+
+  size_type getSize() const
+  {
+    return items().getSize();
+  }
+
+  void reserve(size_type newCapacity)
+  {
+    detach().reserve(newCapacity);
+  }
+
+  void append(const Type& item)
+  {
+    detach().append(item);
+  }
+
+  void append(Type&& item)
+  {
+    detach().append(std::move(item));
+  }
+
+  void prepend(const Type& item)
+  {
+    detach().prepend(item);
+  }
+
+  void prepend(Type&& item)
+  {
+    detach().prepend(std::move(item));
+  }
+
+  template <typename... Args>
+  void emplaceAppend(Args&&... args)
+  {
+    detach().emplaceAppend(std::forward<Args>(args)...);
+  }
+
+  Type popFirst()
+  {
+    return detach().popFirst();
+  }
+
+  Type popLast()
+  {
+    return detach().popLast();
+  }
+
+  // positions may come from this copy before it was detached
+  void insert(const const_iterator& insertPosition, const Type& item);
+  void insert(const const_iterator& insertPosition, Type&& item);
+  void erase(const const_iterator& position);
+  void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded);
+
+  iterator begin()
+  {
+    return leak().begin();
+  }
+
+  iterator end()
+  {
+    return leak().end();
+  }
+
+  const_iterator cbegin() const
+  {
+    return items().cbegin();
+  }
+
+  const_iterator cend() const
+  {
+    return items().cend();
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+};
+
+template <typename Type, class Instrumentation, class Checking>
+CowVector<Type, Instrumentation, Checking> :: CowVector()
+    : shared(nullptr)
+{}
+
+template <typename Type, class Instrumentation, class Checking>
+CowVector<Type, Instrumentation, Checking> :: CowVector(std::initializer_list<Type> l)
+    : shared(new Shared(Items(l)))
+{}
+
+template <typename Type, class Instrumentation, class Checking>
+CowVector<Type, Instrumentation, Checking> :: CowVector(Items items)
+    : shared(new Shared(std::move(items)))
+{}
+
+template <typename Type, class Instrumentation, class Checking>
+CowVector<Type, Instrumentation, Checking> :: CowVector(const CowVector& other)
+    : shared(other.shared)
+{
+    if (shared == nullptr) return;
+    if (shared->unshareable) shared = new Shared(shared->items);
+    else shared->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename Type, class Instrumentation, class Checking>
+CowVector<Type, Instrumentation, Checking> :: CowVector(CowVector&& other)
+    : shared(other.shared)
+{
+    other.shared = nullptr;
+}
+
+template <typename Type, class Instrumentation, class Checking>
+CowVector<Type, Instrumentation, Checking> :: ~CowVector()
+{
+    release();
+}
+
+template <typename Type, class Instrumentation, class Checking>
+CowVector<Type, Instrumentation, Checking>& CowVector<Type, Instrumentation, Checking> :: operator=(CowVector other)
+{
+    swapVectors(*this, other);
+    return *this;
+}
+
+template <typename Type, class Instrumentation, class Checking>
+void CowVector<Type, Instrumentation, Checking> :: swapVectors(CowVector& x, CowVector& y)
+{
+    std::swap(x.shared, y.shared);
+}
+
+// The last owner to let go frees the items; acq_rel makes every other
+// owner's reads of them happen before that.
+template <typename Type, class Instrumentation, class Checking>
+void CowVector<Type, Instrumentation, Checking> :: release()
+{
+    if (shared != nullptr && shared->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete shared;
+    shared = nullptr;
+}
+
+// A count of one cannot go up behind our back: only copies of this object
+// could raise it, and those would have to be made on this thread.
+template <typename Type, class Instrumentation, class Checking>
+typename CowVector<Type, Instrumentation, Checking>::Items& CowVector<Type, Instrumentation, Checking> :: detach()
+{
+    if (shared == nullptr)
+        shared = new Shared(Items());
+    else if (shared->references.load(std::memory_order_acquire) != 1)
+    {
+        Shared* own = new Shared(shared->items);
+        release();
+        shared = own;
+    }
+    return shared->items;
+}
+
+// Only the sole owner marks the items, and a copy never shares marked items,
+// so the flag is never read and written by two threads at once.
+template <typename Type, class Instrumentation, class Checking>
+typename CowVector<Type, Instrumentation, Checking>::Items& CowVector<Type, Instrumentation, Checking> :: leak()
+{
+    Items& own = detach();
+    shared->unshareable = true;
+    return own;
+}
+
+template <typename Type, class Instrumentation, class Checking>
+void CowVector<Type, Instrumentation, Checking> :: insert(const const_iterator& insertPosition, const Type& item)
+{
+    const difference_type i = insertPosition.getIndex();
+    Items& own = detach();
+    own.insert(own.cbegin() + i, item);
+}
+
+template <typename Type, class Instrumentation, class Checking>
+void CowVector<Type, Instrumentation, Checking> :: insert(const const_iterator& insertPosition, Type&& item)
+{
+    const difference_type i = insertPosition.getIndex();
+    Items& own = detach();
+    own.insert(own.cbegin() + i, std::move(item));
+}
+
+template <typename Type, class Instrumentation, class Checking>
+void CowVector<Type, Instrumentation, Checking> :: erase(const const_iterator& position)
+{
+    const difference_type i = position.getIndex();
+    Items& own = detach();
+    own.erase(own.cbegin() + i);
+}
+
+template <typename Type, class Instrumentation, class Checking>
+void CowVector<Type, Instrumentation, Checking> :: erase(const const_iterator& firstIncluded,
+                                                          const const_iterator& lastExcluded)
+{
+    const difference_type from = firstIncluded.getIndex(), to = lastExcluded.getIndex();
+    Items& own = detach();
+    own.erase(own.cbegin() + from, own.cbegin() + to);
+}
+
+}
+#endif // AISDI_LINEAR_COWVECTOR_H
@@ -0,0 +1,134 @@
+#ifndef AISDI_LINEAR_INSTRUMENTATION_H
+#define AISDI_LINEAR_INSTRUMENTATION_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace aisdi
+{
+
+struct InstrumentationCounters
+{
+  std::size_t allocations = 0;     // buffers or nodes taken from an allocator
+  std::size_t bytesAllocated = 0;
+  std::size_t reallocations = 0;   // Vector buffer regrowths (addMemory, reserve, ...)
+  std::size_t elementsMoved = 0;   // elements relocated by memmove or move loops
+  std::size_t nodeAllocations = 0;
+  std::size_t nodeFrees = 0;
+  std::size_t iteratorSteps = 0;
+};
+
+// Instrumentation policies. Containers inherit privately from the policy, so
+// the empty NoInstrumentation adds no members, and its hooks compile away.
+
+struct NoInstrumentation
+{
+  void countAllocation(std::size_t) const {}
+  void countReallocation() const {}
+  void countMoved(std::size_t) const {}
+  void countNodeAllocation(std::size_t) const {}
+  void countNodeFree() const {}
+  void countIteratorSteps(std::size_t) const {}
+
+  InstrumentationCounters getCounters() const
+  {
+    return InstrumentationCounters();
+  }
+};
+
+// Counts per instance and, at the same time, in process-wide totals.
+class CountingInstrumentation
+{
+private:
+  struct GlobalCounters
+  {
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> bytesAllocated{0};
+    std::atomic<std::size_t> reallocations{0};
+    std::atomic<std::size_t> elementsMoved{0};
+    std::atomic<std::size_t> nodeAllocations{0};
+    std::atomic<std::size_t> nodeFrees{0};
+    std::atomic<std::size_t> iteratorSteps{0};
+  };
+
+  static GlobalCounters& global()
+  {
+    static GlobalCounters counters;
+    return counters;
+  }
+
+  static void add(std::atomic<std::size_t>& counter, std::size_t value)
+  {
+    counter.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  // iterators only see their container as const
+  mutable InstrumentationCounters counters;
+
+public:
+  void countAllocation(std::size_t bytes) const
+  {
+    counters.allocations++;
+    counters.bytesAllocated += bytes;
+    add(global().allocations, 1);
+    add(global().bytesAllocated, bytes);
+  }
+
+  void countReallocation() const
+  {
+    counters.reallocations++;
+    add(global().reallocations, 1);
+  }
+
+  void countMoved(std::size_t count) const
+  {
+    counters.elementsMoved += count;
+    add(global().elementsMoved, count);
+  }
+
+  void countNodeAllocation(std::size_t bytes) const
+  {
+    countAllocation(bytes);
+    counters.nodeAllocations++;
+    add(global().nodeAllocations, 1);
+  }
+
+  void countNodeFree() const
+  {
+    counters.nodeFrees++;
+    add(global().nodeFrees, 1);
+  }
+
+  void countIteratorSteps(std::size_t steps) const
+  {
+    counters.iteratorSteps += steps;
+    add(global().iteratorSteps, steps);
+  }
+
+  InstrumentationCounters getCounters() const
+  {
+    return counters;
+  }
+
+  void resetCounters()
+  {
+    counters = InstrumentationCounters();
+  }
+
+  // totals over every instrumented container since the process started
+  static InstrumentationCounters getGlobalCounters()
+  {
+    InstrumentationCounters result;
+    result.allocations = global().allocations.load(std::memory_order_relaxed);
+    result.bytesAllocated = global().bytesAllocated.load(std::memory_order_relaxed);
+    result.reallocations = global().reallocations.load(std::memory_order_relaxed);
+    result.elementsMoved = global().elementsMoved.load(std::memory_order_relaxed);
+    result.nodeAllocations = global().nodeAllocations.load(std::memory_order_relaxed);
+    result.nodeFrees = global().nodeFrees.load(std::memory_order_relaxed);
+    result.iteratorSteps = global().iteratorSteps.load(std::memory_order_relaxed);
+    return result;
+  }
+};
+
+}
+#endif // AISDI_LINEAR_INSTRUMENTATION_H
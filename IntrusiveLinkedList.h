@@ -0,0 +1,455 @@
+#ifndef AISDI_LINEAR_INTRUSIVELINKEDLIST_H
+#define AISDI_LINEAR_INTRUSIVELINKEDLIST_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <iterator>
+#include "Checking.h"
+
+namespace aisdi
+{
+
+// Links embedded in an object so that it can be put on an
+// IntrusiveLinkedList<Type, &Type::hook> without any allocation. An object
+// is on at most one list per hook. Copies of an object start unlinked.
+template <typename Type>
+class IntrusiveListHook
+{
+private:
+  template <typename T, IntrusiveListHook<T> T::*, class>
+  friend class IntrusiveLinkedList;
+
+  Type* next;
+  Type* prev;
+  const void* owner; // list the object is on, nullptr when unlinked
+
+public:
+  IntrusiveListHook()
+    : next(nullptr), prev(nullptr), owner(nullptr)
+  {}
+
+  IntrusiveListHook(const IntrusiveListHook&)
+    : IntrusiveListHook()
+  {}
+
+  IntrusiveListHook& operator=(const IntrusiveListHook&)
+  {
+    return *this;
+  }
+
+  bool isLinked() const
+  {
+    return owner != nullptr;
+  }
+};
+
+// Doubly linked list threaded through the objects themselves: the list never
+// allocates, copies or destroys items, it only relinks them. Items must stay
+// alive (and in place) while they are on the list; the list unlinks whatever
+// is left on it when it is destroyed.
+template <typename Type, IntrusiveListHook<Type> Type::*Hook, class Checking = DefaultChecking>
+class IntrusiveLinkedList
+{
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+private:
+  Type* first;
+  Type* last;
+  size_type n;
+
+  static IntrusiveListHook<Type>& hookOf(const Type* item)
+  {
+    return const_cast<Type*>(item)->*Hook;
+  }
+
+  void linkBefore(Type* position, Type& item);
+  void unlink(Type& item);
+
+public:
+  IntrusiveLinkedList();
+  IntrusiveLinkedList(const IntrusiveLinkedList&) = delete;
+  IntrusiveLinkedList& operator=(const IntrusiveLinkedList&) = delete;
+  ~IntrusiveLinkedList();
+
+  bool isEmpty() const;
+
+  size_type getSize() const;
+
+  bool contains(const Type& item) const; //O(1), checks the item's hook
+
+  void append(Type& item);
+
+  void prepend(Type& item);
+
+  void insert(const const_iterator& insertPosition, Type& item);
+
+  Type& popFirst();
+
+  Type& popLast();
+
+  void erase(const const_iterator& possition);
+
+  void erase(Type& item); //O(1), straight from the item
+
+  void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded);
+
+  void clear(); //unlinks every item
+
+  iterator iteratorTo(Type& item);
+
+  const_iterator iteratorTo(const Type& item) const;
+
+  iterator begin()
+  {
+    return Iterator(ConstIterator(this, first));
+  }
+
+  iterator end()
+  {
+    return Iterator(ConstIterator(this, nullptr));
+  }
+
+  const_iterator cbegin() const
+  {
+    return ConstIterator(this, first);
+  }
+
+  const_iterator cend() const
+  {
+    return ConstIterator(this, nullptr);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+};
+
+template <typename Type, IntrusiveListHook<Type> Type::*Hook, class Checking>
+class IntrusiveLinkedList<Type, Hook, Checking>::ConstIterator
+{
+public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename IntrusiveLinkedList::value_type;
+  using difference_type = typename IntrusiveLinkedList::difference_type;
+  using pointer = typename IntrusiveLinkedList::const_pointer;
+  using reference = typename IntrusiveLinkedList::const_reference;
+private:
+  const IntrusiveLinkedList* mylist;
+  Type* node;
+
+public:
+  explicit ConstIterator() {}
+
+  ConstIterator(const IntrusiveLinkedList* l, Type* item)
+  {
+    mylist = l;
+    node = item;
+  }
+
+  reference operator*() const
+  {
+    if (Checking::enabled && node == nullptr) throw std::out_of_range("there is no such item");
+    return *node;
+  }
+
+  pointer operator->() const
+  {
+    return &operator*();
+  }
+
+  Type* GetNode() const
+  {
+    return node;
+  }
+
+  ConstIterator& operator++()
+  {
+    if (Checking::enabled && node == nullptr) throw std::out_of_range("you cannot increase iterator");
+    node = hookOf(node).next;
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp(*this);
+    operator++();
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    if (Checking::enabled && node == mylist->first) throw std::out_of_range("you cannot decrease iterator");
+    if (node == nullptr) node = mylist->last;
+    else node = hookOf(node).prev;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp(*this);
+    operator--();
+    return tmp;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    ConstIterator tmp(*this);
+    for (difference_type i = 0; i < d; i++) ++tmp;
+    for (difference_type i = 0; i > d; i--) --tmp;
+    return tmp;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    return operator+(-d);
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return mylist == other.mylist && node == other.node;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+template <typename Type, IntrusiveListHook<Type> Type::*Hook, class Checking>
+class IntrusiveLinkedList<Type, Hook, Checking>::Iterator : public IntrusiveLinkedList<Type, Hook, Checking>::ConstIterator
+{
+public:
+  using pointer = typename IntrusiveLinkedList::pointer;
+  using reference = typename IntrusiveLinkedList::reference;
+
+  explicit Iterator() {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  reference operator*() const
+  {
+    // ugly cast, yet reduces code duplication.
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+
+  pointer operator->() const
+  {
+    return &operator*();
+  }
+};
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+IntrusiveLinkedList <value_type, Hook, Checking> :: IntrusiveLinkedList()
+{
+    first = nullptr;
+    last = nullptr;
+    n = 0;
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+IntrusiveLinkedList <value_type, Hook, Checking> :: ~IntrusiveLinkedList()
+{
+    clear();
+}
+
+// links item in front of position, or at the back when position is nullptr
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+void IntrusiveLinkedList <value_type, Hook, Checking> :: linkBefore(value_type* position, value_type& item)
+{
+    IntrusiveListHook<value_type>& hook = item.*Hook;
+    if (hook.owner != nullptr) throw std::logic_error("item is already on a list");
+    hook.owner = this;
+    hook.next = position;
+    hook.prev = position == nullptr ? last : hookOf(position).prev;
+    if (hook.prev != nullptr) hookOf(hook.prev).next = &item;
+    else first = &item;
+    if (position != nullptr) hookOf(position).prev = &item;
+    else last = &item;
+    n++;
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+void IntrusiveLinkedList <value_type, Hook, Checking> :: unlink(value_type& item)
+{
+    IntrusiveListHook<value_type>& hook = item.*Hook;
+    if (hook.prev != nullptr) hookOf(hook.prev).next = hook.next;
+    else first = hook.next;
+    if (hook.next != nullptr) hookOf(hook.next).prev = hook.prev;
+    else last = hook.prev;
+    hook.next = nullptr;
+    hook.prev = nullptr;
+    hook.owner = nullptr;
+    n--;
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+bool IntrusiveLinkedList <value_type, Hook, Checking> :: isEmpty() const
+{
+    return n == 0;
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+size_t IntrusiveLinkedList <value_type, Hook, Checking> :: getSize() const
+{
+    return n;
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+bool IntrusiveLinkedList <value_type, Hook, Checking> :: contains(const value_type& item) const
+{
+    return (item.*Hook).owner == this;
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+void IntrusiveLinkedList <value_type, Hook, Checking> :: append(value_type& item)
+{
+    linkBefore(nullptr, item);
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+void IntrusiveLinkedList <value_type, Hook, Checking> :: prepend(value_type& item)
+{
+    linkBefore(first, item);
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+void IntrusiveLinkedList <value_type, Hook, Checking> :: insert(const const_iterator& insertPosition, value_type& item)
+{
+    linkBefore(insertPosition.GetNode(), item);
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+value_type& IntrusiveLinkedList <value_type, Hook, Checking> :: popFirst()
+{
+    if (n == 0) throw std::logic_error("list is empty");
+    value_type& item = *first;
+    unlink(item);
+    return item;
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+value_type& IntrusiveLinkedList <value_type, Hook, Checking> :: popLast()
+{
+    if (n == 0) throw std::logic_error("list is empty");
+    value_type& item = *last;
+    unlink(item);
+    return item;
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+void IntrusiveLinkedList <value_type, Hook, Checking> :: erase(const const_iterator& possition)
+{
+    if (possition.GetNode() == nullptr) throw std::out_of_range("");
+    unlink(*possition.GetNode());
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+void IntrusiveLinkedList <value_type, Hook, Checking> :: erase(value_type& item)
+{
+    if (!contains(item)) throw std::logic_error("item is not on this list");
+    unlink(item);
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+void IntrusiveLinkedList <value_type, Hook, Checking> :: erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+{
+    value_type* node = firstIncluded.GetNode();
+    value_type* stop = lastExcluded.GetNode();
+    while (node != stop)
+    {
+        if (node == nullptr) throw std::out_of_range("");
+        value_type* next = hookOf(node).next;
+        unlink(*node);
+        node = next;
+    }
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+void IntrusiveLinkedList <value_type, Hook, Checking> :: clear()
+{
+    while (first != nullptr)
+    {
+        IntrusiveListHook<value_type>& hook = first->*Hook;
+        first = hook.next;
+        hook.next = nullptr;
+        hook.prev = nullptr;
+        hook.owner = nullptr;
+    }
+    last = nullptr;
+    n = 0;
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+typename IntrusiveLinkedList <value_type, Hook, Checking> :: iterator
+IntrusiveLinkedList <value_type, Hook, Checking> :: iteratorTo(value_type& item)
+{
+    if (!contains(item)) throw std::logic_error("item is not on this list");
+    return Iterator(ConstIterator(this, &item));
+}
+
+template <class value_type, IntrusiveListHook<value_type> value_type::*Hook, class Checking>
+typename IntrusiveLinkedList <value_type, Hook, Checking> :: const_iterator
+IntrusiveLinkedList <value_type, Hook, Checking> :: iteratorTo(const value_type& item) const
+{
+    if (!contains(item)) throw std::logic_error("item is not on this list");
+    return ConstIterator(this, const_cast<value_type*>(&item));
+}
+
+}
+#endif // AISDI_LINEAR_INTRUSIVELINKEDLIST_H
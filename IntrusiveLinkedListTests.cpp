@@ -0,0 +1,183 @@
+#include <IntrusiveLinkedList.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+namespace
+{
+
+// An item that can be on two lists at once, one per hook.
+struct Task
+{
+  int id;
+  aisdi::IntrusiveListHook<Task> queueHook;
+  aisdi::IntrusiveListHook<Task> ownerHook;
+
+  explicit Task(int i) : id(i) {}
+};
+
+using Queue = aisdi::IntrusiveLinkedList<Task, &Task::queueHook, aisdi::CheckedIterators>;
+using Owned = aisdi::IntrusiveLinkedList<Task, &Task::ownerHook, aisdi::CheckedIterators>;
+
+template <typename List>
+void thenListContainsIds(const List& list, std::initializer_list<int> expected)
+{
+  std::vector<int> ids;
+  for (const Task& task : list) ids.push_back(task.id);
+  BOOST_CHECK_EQUAL(list.getSize(), expected.size());
+  BOOST_CHECK(std::equal(ids.begin(), ids.end(), expected.begin(), expected.end()));
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(IntrusiveLinkedListTests)
+
+BOOST_AUTO_TEST_CASE(GivenEmptyList_WhenPopping_ThenExceptionIsThrown)
+{
+  Queue queue;
+
+  BOOST_CHECK(queue.isEmpty());
+  BOOST_CHECK(queue.begin() == queue.end());
+  BOOST_CHECK_THROW(queue.popFirst(), std::logic_error);
+  BOOST_CHECK_THROW(queue.popLast(), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(GivenItems_WhenLinking_ThenListHoldsTheObjectsThemselves)
+{
+  Task a(1), b(2), c(3), d(4);
+  Queue queue;
+
+  queue.append(b);
+  queue.prepend(a);
+  queue.append(d);
+  queue.insert(queue.iteratorTo(d), c);
+
+  thenListContainsIds(queue, { 1, 2, 3, 4 });
+  BOOST_CHECK_EQUAL(&*queue.begin(), &a);
+  BOOST_CHECK(queue.contains(c));
+  BOOST_CHECK(c.queueHook.isLinked());
+  BOOST_CHECK(!c.ownerHook.isLinked());
+}
+
+BOOST_AUTO_TEST_CASE(GivenLinkedItem_WhenLinkingItAgain_ThenExceptionIsThrown)
+{
+  Task a(1);
+  Queue queue, other;
+  queue.append(a);
+
+  BOOST_CHECK_THROW(queue.append(a), std::logic_error);
+  BOOST_CHECK_THROW(other.prepend(a), std::logic_error);
+  BOOST_CHECK_EQUAL(queue.getSize(), 1);
+  BOOST_CHECK(other.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(GivenItemOnTwoLists_WhenErasingFromOne_ThenItStaysOnTheOther)
+{
+  Task a(1), b(2), c(3);
+  Queue queue;
+  Owned owned;
+  for (Task* task : { &a, &b, &c })
+  {
+    queue.append(*task);
+    owned.prepend(*task);
+  }
+
+  queue.erase(b);
+
+  thenListContainsIds(queue, { 1, 3 });
+  thenListContainsIds(owned, { 3, 2, 1 });
+  BOOST_CHECK(!b.queueHook.isLinked());
+  BOOST_CHECK(owned.contains(b));
+  BOOST_CHECK_THROW(queue.erase(b), std::logic_error);
+  BOOST_CHECK_THROW(queue.iteratorTo(b), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(GivenList_WhenErasingAndPopping_ThenItemsAreUnlinked)
+{
+  Task a(1), b(2), c(3), d(4), e(5);
+  Queue queue;
+  for (Task* task : { &a, &b, &c, &d, &e }) queue.append(*task);
+
+  queue.erase(queue.begin() + 1);
+  BOOST_CHECK_EQUAL(&queue.popFirst(), &a);
+  BOOST_CHECK_EQUAL(&queue.popLast(), &e);
+  thenListContainsIds(queue, { 3, 4 });
+  BOOST_CHECK(!a.queueHook.isLinked());
+  BOOST_CHECK(!b.queueHook.isLinked());
+  BOOST_CHECK_THROW(queue.erase(queue.end()), std::out_of_range);
+
+  queue.append(a);
+  queue.append(b);
+  queue.erase(queue.begin() + 1, queue.end() - 1);
+  thenListContainsIds(queue, { 3, 2 });
+  BOOST_CHECK(!d.queueHook.isLinked());
+}
+
+BOOST_AUTO_TEST_CASE(GivenList_WhenMovingIterators_ThenTheyWalkTheHooks)
+{
+  Task a(1), b(2), c(3);
+  Queue queue;
+  for (Task* task : { &a, &b, &c }) queue.append(*task);
+
+  auto it = queue.begin();
+  BOOST_CHECK_EQUAL((++it)->id, 2);
+  BOOST_CHECK_EQUAL((it + 1)->id, 3);
+  BOOST_CHECK_EQUAL((it - 1)->id, 1);
+  BOOST_CHECK_EQUAL((--queue.end())->id, 3);
+  BOOST_CHECK(queue.begin() + 3 == queue.end());
+  BOOST_CHECK(queue.iteratorTo(c) + 1 == queue.end());
+  BOOST_CHECK_THROW(queue.end()++, std::out_of_range);
+  BOOST_CHECK_THROW(queue.begin()--, std::out_of_range);
+  BOOST_CHECK_THROW(*queue.end(), std::out_of_range);
+
+  for (Task& task : queue) task.id *= 10;
+  thenListContainsIds(queue, { 10, 20, 30 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenCopyOfLinkedItem_WhenCopied_ThenCopyStartsUnlinked)
+{
+  Task a(1);
+  Queue queue;
+  queue.append(a);
+
+  Task copy = a;
+  Task assigned(2);
+  assigned = a;
+
+  BOOST_CHECK(!copy.queueHook.isLinked());
+  BOOST_CHECK(!assigned.queueHook.isLinked());
+  BOOST_CHECK(a.queueHook.isLinked());
+  queue.append(copy);
+  thenListContainsIds(queue, { 1, 1 });
+  queue.clear();
+}
+
+BOOST_AUTO_TEST_CASE(GivenListWithItems_WhenClearedOrDestroyed_ThenItemsAreUnlinked)
+{
+  Task a(1), b(2);
+  {
+    Queue queue;
+    queue.append(a);
+    queue.append(b);
+    queue.clear();
+    BOOST_CHECK(queue.isEmpty());
+    BOOST_CHECK(!a.queueHook.isLinked());
+
+    queue.append(a);
+    queue.append(b);
+  }
+  BOOST_CHECK(!a.queueHook.isLinked());
+  BOOST_CHECK(!b.queueHook.isLinked());
+
+  Queue other;
+  other.append(b);
+  other.append(a);
+  thenListContainsIds(other, { 2, 1 });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,14 +2,39 @@
 #define AISDI_LINEAR_LINKEDLIST_H
 
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
 #include <stdexcept>
 #include <iostream>
+#include <iterator>
+#include <new>
+#include <utility>
+#include "Checking.h"
+#include "Instrumentation.h"
+#include "NodePool.h"
 namespace aisdi
 {
 
-template <typename Type>
-class LinkedList
+// Positional indexing policies. With FingerIndex the list remembers the
+// last position reached by offset (the finger), so offsets near it walk only
+// the distance from there; moving the finger is a write even through const
+// iterators, so then const access to one list is not thread-safe. NoIndex
+// walks from the nearer end, and const access stays read-only.
+
+struct FingerIndex
+{
+  static constexpr bool enabled = true;
+};
+
+struct NoIndex
+{
+  static constexpr bool enabled = false;
+};
+
+template <typename Type, template <typename> class NodeAllocator = NodePool,
+          class Instrumentation = NoInstrumentation, class Checking = DefaultChecking,
+          class Indexing = NoIndex>
+class LinkedList : private Instrumentation
 {
 
 
@@ -34,10 +59,36 @@ private:
       value_type item;
       Item *next;
       Item *prev;
+
+      template <typename... Args>
+      explicit Item(Args&&... args)
+        : item(std::forward<Args>(args)...), next(nullptr), prev(nullptr)
+      {}
   };
  Item *first;
  Item *last;
  int   n;
+ NodeAllocator<Item> allocator; // every Item of this list comes from here
+ // finger: the last position reached by offset, so that nearby offsets walk
+ // only from there; always nullptr unless Indexing is FingerIndex. Iterators
+ // see the list as const, hence mutable.
+ mutable Item* finger; // nullptr when unknown
+ mutable size_type fingerIndex;
+
+ template <typename... Args>
+ Item* createItem(Args&&... args);
+ void destroyItem(Item* node);
+ void linkBefore(Item* position, Item* node);
+ void linkRunBefore(Item* position, Item* head, Item* tail, size_type count);
+ void unlinkRun(Item* head, Item* tail);
+ Item* locate(size_type index) const;
+ bool indexOf(const Item* node, size_type& index) const;
+ void fingerLinking(Item* position, Item* head, size_type count);
+ void fingerUnlinking(Item* node);
+ template <typename Compare>
+ static void mergeChains(Item*& into, Item* later, Compare& compare);
+ void relinkPrevious();
+ void clear();
 public:
   LinkedList();
 
@@ -57,12 +108,40 @@ public:
 
   size_type getSize() const;
 
+  const Instrumentation& getInstrumentation() const
+  {
+    return *this;
+  }
+
   void append(const Type& item);
 
+  void append(Type&& item);
+
   void prepend(const Type& item);
 
+  void prepend(Type&& item);
+
+  template <typename... Args>
+  void emplaceAppend(Args&&... args);
+
+  template <typename... Args>
+  void emplacePrepend(Args&&... args);
+
   void insert(const const_iterator& insertPosition, const Type& item);
 
+  void insert(const const_iterator& insertPosition, Type&& item);
+
+  template <typename... Args>
+  void emplace(const const_iterator& position, Args&&... args);
+
+  template <typename InputIterator>
+  void appendRange(InputIterator firstItem, InputIterator lastItem);
+
+  template <typename InputIterator>
+  void insert(const const_iterator& insertPosition, InputIterator firstItem, InputIterator lastItem);
+
+  void insert(const const_iterator& insertPosition, std::initializer_list<Type> l);
+
   Type popFirst();
 
   Type popLast();
@@ -71,6 +150,24 @@ public:
 
   void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded);
 
+  // Splicing only relinks nodes; the lists' node pools are shared from then
+  // on. Iterators to moved items have to be taken again from their new list,
+  // and position must not lie inside the moved range.
+  void splice(const const_iterator& position, LinkedList& other);
+
+  void splice(const const_iterator& position, LinkedList& other,
+              const const_iterator& firstIncluded, const const_iterator& lastExcluded);
+
+  LinkedList splitAt(const const_iterator& position); //returns [position, end), this keeps the rest
+
+  void concat(LinkedList& other);
+
+  // Stable bottom-up merge sort that only relinks nodes: nothing is
+  // allocated, copied or moved, and iterators keep pointing at their items.
+  // If compare throws, all items stay in the list in an unspecified order.
+  template <typename Compare = std::less<Type>>
+  void sort(Compare compare = Compare());
+
 
   iterator begin()
   {
@@ -107,8 +204,8 @@ public:
   }
 };
 
-template <typename Type>
-class LinkedList<Type>::ConstIterator
+template <typename Type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+class LinkedList<Type, NodeAllocator, Instrumentation, Checking, Indexing>::ConstIterator
 {
 public:
   using iterator_category = std::bidirectional_iterator_tag;
@@ -125,7 +222,7 @@ public:
 
   reference operator*() const
   {
-    if (node == nullptr) throw std::out_of_range("there is no such item");
+    if (Checking::enabled && node == nullptr) throw std::out_of_range("there is no such item");
     return node->item;
   }
 
@@ -147,23 +244,25 @@ ConstIterator(const LinkedList* l, Item* item)
   }
   ConstIterator& operator++()
   {
-     if (node == nullptr) throw std::out_of_range("you cannot increase iterator");
+     if (Checking::enabled && node == nullptr) throw std::out_of_range("you cannot increase iterator");
+     mylist->countIteratorSteps(1);
      node = node->next;
      return *this;
   }
 
   ConstIterator operator++(int)
   {
-    if (node == mylist->last) node = nullptr;
-    if ( node == nullptr ) throw std::out_of_range("you cannot increase iterator");
+    if (Checking::enabled && node == nullptr) throw std::out_of_range("you cannot increase iterator");
     ConstIterator tmp(*this);
+    mylist->countIteratorSteps(1);
     node = node->next;
     return tmp;
   }
 
   ConstIterator& operator--()
   {
-     if (mylist->n == 0) throw std::out_of_range("you cannot decrease iterator");
+     if (Checking::enabled && node == mylist->first) throw std::out_of_range("you cannot decrease iterator");
+     mylist->countIteratorSteps(1);
      if (node == nullptr) node = mylist->last;
      else node = node->prev;
      return *this;
@@ -171,8 +270,9 @@ ConstIterator(const LinkedList* l, Item* item)
 
   ConstIterator operator--(int)
   {
-    if (mylist->n == 0) throw std::out_of_range("you cannot decrease iterator");
+    if (Checking::enabled && node == mylist->first) throw std::out_of_range("you cannot decrease iterator");
     ConstIterator tmp(*this);
+    mylist->countIteratorSteps(1);
     if (node == nullptr) node = mylist->last;
     else node = node->prev;
     return tmp;
@@ -180,10 +280,19 @@ ConstIterator(const LinkedList* l, Item* item)
 
   ConstIterator operator+(difference_type d) const
   {
+    if (d < 0) return operator-(-d);
     ConstIterator tmp(*this);
+    size_type index;
+    if (mylist->indexOf(node, index))
+    {
+        if (Checking::enabled && static_cast<size_type>(d) > mylist->n - index) throw std::out_of_range("you cannot increase iterator");
+        tmp.node = index + static_cast<size_type>(d) == static_cast<size_type>(mylist->n) ? nullptr : mylist->locate(index + d);
+        return tmp;
+    }
+    mylist->countIteratorSteps(d);
     for (int i=0; i<d;i++)
     {
-        if (node == nullptr) throw std::out_of_range("you cannot increase iterator");
+        if (Checking::enabled && tmp.node == nullptr) throw std::out_of_range("you cannot increase iterator");
         tmp.node = tmp.node->next;
     }
     return tmp;
@@ -191,10 +300,19 @@ ConstIterator(const LinkedList* l, Item* item)
 
   ConstIterator operator-(difference_type d) const
   {
+    if (d < 0) return operator+(-d);
     ConstIterator tmp(*this);
+    size_type index;
+    if (mylist->indexOf(node, index))
+    {
+        if (Checking::enabled && static_cast<size_type>(d) > index) throw std::out_of_range("you cannot decrease iterator");
+        tmp.node = d == 0 ? node : mylist->locate(index - d);
+        return tmp;
+    }
+    mylist->countIteratorSteps(d);
     for (int i=0; i<d;i++)
     {
-        if (tmp.node == mylist->first) throw std::out_of_range("you cannot decrease iterator");
+        if (Checking::enabled && tmp.node == mylist->first) throw std::out_of_range("you cannot decrease iterator");
         if (tmp.node == nullptr) tmp.node = mylist->last;
         else tmp.node = tmp.node->prev;
     }
@@ -214,8 +332,8 @@ ConstIterator(const LinkedList* l, Item* item)
   }
 };
 
-template <typename Type>
-class LinkedList<Type>::Iterator : public LinkedList<Type>::ConstIterator
+template <typename Type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+class LinkedList<Type, NodeAllocator, Instrumentation, Checking, Indexing>::Iterator : public LinkedList<Type, NodeAllocator, Instrumentation, Checking, Indexing>::ConstIterator
 {
 public:
   using pointer = typename LinkedList::pointer;
@@ -271,328 +389,606 @@ public:
 };
 
 
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+template <typename... Args>
+typename LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: Item*
+LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: createItem(Args&&... args)
+{
+    Item* node = allocator.allocate();
+    try
+    {
+        new (node) Item(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        allocator.deallocate(node);
+        throw;
+    }
+    this->countNodeAllocation(sizeof(Item)); // only nodes that destroyItem will free
+    return node;
+}
 
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: destroyItem(Item* node)
+{
+    node->~Item();
+    allocator.deallocate(node);
+    this->countNodeFree();
+}
 
+// links node in front of position, or at the back when position is nullptr
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: linkBefore(Item* position, Item* node)
+{
+    linkRunBefore(position, node, node, 1);
+}
 
+// links the chain head..tail of count nodes in front of position
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: linkRunBefore(Item* position, Item* head, Item* tail, size_type count)
+{
+    fingerLinking(position, head, count);
+    tail->next = position;
+    head->prev = position == nullptr ? last : position->prev;
+    if (head->prev != nullptr) head->prev->next = head;
+    else first = head;
+    if (position != nullptr) position->prev = tail;
+    else last = tail;
+    n += count;
+}
 
+// cuts head..tail out of the list, leaving it a chain of its own; the caller
+// fixes n and the finger
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: unlinkRun(Item* head, Item* tail)
+{
+    if (head->prev != nullptr) head->prev->next = tail->next;
+    else first = tail->next;
+    if (tail->next != nullptr) tail->next->prev = head->prev;
+    else last = head->prev;
+    head->prev = nullptr;
+    tail->next = nullptr;
+}
 
+// walks to index from the nearest of first, last and the finger, and leaves
+// the finger there when Indexing keeps one
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+typename LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: Item*
+LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: locate(size_type index) const
+{
+    size_type fromFirst = index, fromLast = n - 1 - index;
+    Item* node;
+    if (fromFirst <= fromLast && (finger == nullptr || fromFirst <= (fingerIndex > index ? fingerIndex - index : index - fingerIndex)))
+    {
+        node = first;
+        for (size_type i = 0; i < fromFirst; i++) node = node->next;
+        this->countIteratorSteps(fromFirst);
+    }
+    else if (finger == nullptr || fromLast <= (fingerIndex > index ? fingerIndex - index : index - fingerIndex))
+    {
+        node = last;
+        for (size_type i = 0; i < fromLast; i++) node = node->prev;
+        this->countIteratorSteps(fromLast);
+    }
+    else
+    {
+        node = finger;
+        for (size_type i = fingerIndex; i < index; i++) node = node->next;
+        for (size_type i = fingerIndex; i > index; i--) node = node->prev;
+        this->countIteratorSteps(fingerIndex > index ? fingerIndex - index : index - fingerIndex);
+    }
+    if (Indexing::enabled)
+    {
+        finger = node;
+        fingerIndex = index;
+    }
+    return node;
+}
 
+// position of node if it can be told without walking (nullptr is end)
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+bool LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: indexOf(const Item* node, size_type& index) const
+{
+    if (node == nullptr) index = n;
+    else if (node == first) index = 0;
+    else if (node == finger) index = fingerIndex;
+    else if (node == last) index = n - 1;
+    else return false;
+    return true;
+}
 
+// keeps the finger valid while a chain of count nodes starting at head is
+// linked in front of position; forgets it when that cannot be done cheaply
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: fingerLinking(Item* position, Item* head, size_type count)
+{
+    if (finger == nullptr || position == nullptr || position == finger->next) return;
+    if (position == finger) finger = head;
+    else if (position == first) fingerIndex += count;
+    else finger = nullptr;
+}
 
+// same for a single node about to be unlinked
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: fingerUnlinking(Item* node)
+{
+    if (finger == nullptr) return;
+    if (node == finger) finger = node->next; // same index, nullptr past the end
+    else if (node == first || node == finger->prev) fingerIndex--;
+    else if (node != last && node != finger->next) finger = nullptr;
+}
 
-template <class value_type>
-LinkedList <value_type> :: LinkedList()
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: clear()
+{
+    Item *tmp, *current;
+    current = first;
+    while (current != nullptr)
+    {
+        tmp = current->next;
+        destroyItem(current);
+        current = tmp;
+    }
+    first = nullptr;
+    last = nullptr;
+    n = 0;
+    finger = nullptr;
+}
+
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: LinkedList()
 {
     n = 0;
     first = nullptr;
     last = nullptr;
+    finger = nullptr;
+    fingerIndex = 0;
 }
 
-template <class value_type>
-LinkedList <value_type> :: LinkedList(std::initializer_list<value_type> l)
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: LinkedList(std::initializer_list<value_type> l)
 {
     n=0;
     first =nullptr;
     last = nullptr;
-    for (auto it=l.begin(); it != l.end(); it++)
-      append(*it);
+    finger = nullptr;
+    fingerIndex = 0;
+    appendRange(l.begin(), l.end());
 }
-template <class value_type>
-LinkedList <value_type> :: LinkedList(const LinkedList& other)
+
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: LinkedList(const LinkedList& other)
 {
-    Item *current, *current_other, *tmp;
-    n = other.n;
-    if (other.n == 0)
+    n = 0;
+    first = nullptr;
+    last = nullptr;
+    finger = nullptr;
+    fingerIndex = 0;
+    try
     {
-        first = nullptr;
-        last = nullptr;
-        return;
+        for (Item* current = other.first; current != nullptr; current = current->next)
+            append(current->item);
     }
-    current_other = other.first;
-    first = new Item;
-    first->prev = nullptr;
-    current = first;
-    while (current_other != other.last)
+    catch (...)
     {
-       current->item = current_other->item;
-       current->next = new Item;
-       tmp = current;
-       current = current->next;
-       current->prev = tmp;
-       current_other = current_other->next;
+        clear();
+        throw;
     }
-    current->item = current_other->item;
-    current->next = nullptr;
-    last = current;
-
 }
 
-template <class value_type>
-LinkedList <value_type> :: LinkedList(LinkedList&& other)
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: LinkedList(LinkedList&& other)
 {
 
     first = other.first;
     last = other.last;
     n = other.n;
+    finger = other.finger;
+    fingerIndex = other.fingerIndex;
+    allocator.swap(other.allocator);
     other.first = nullptr;
     other.last = nullptr;
     other.n = 0;
+    other.finger = nullptr;
 }
-template <class value_type>
-LinkedList <value_type> :: ~LinkedList()
+
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: ~LinkedList()
 {
-    if (n==0) return;
-    Item *tmp, *current;
-    current = first;
-    while (current != last)
-    {
-        tmp = current->next;
-        delete current;
-        current = tmp;
-    }
-    delete current;
-    n = 0;
+    clear();
 }
 
-template <class value_type>
-bool LinkedList <value_type> :: isEmpty() const
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+bool LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: isEmpty() const
 {
     if (n == 0) return true;
     else return false;
 }
 
-template <class value_type>
-size_t LinkedList <value_type> :: getSize() const
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+size_t LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: getSize() const
 {
     return n;
 }
 
-template <class value_type>
-void  LinkedList <value_type> :: append(const value_type& item)
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void  LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: append(const value_type& item)
 {
-    if (n == 0)
-    {
-        first = new Item;
-        first->item = item;
-        last = first;
-        first->prev = nullptr;
-        last->next = nullptr;
-    }
-    else
-    {
+    linkBefore(nullptr, createItem(item));
+}
 
-        Item *tmp;
-        //tmp = last;
-        tmp = new Item;
-        tmp->item = item;
-        tmp->next = nullptr;
-        tmp->prev = last;
-        last->next = tmp;
-        last =tmp;
-    }
-    n++;
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void  LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: append(value_type&& item)
+{
+    linkBefore(nullptr, createItem(std::move(item)));
 }
 
-template <class value_type>
-void LinkedList <value_type> ::prepend(const value_type& item)
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+template <typename... Args>
+void  LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: emplaceAppend(Args&&... args)
 {
-    Item* tmp;
-    tmp = first;
-    first = new Item;
-    first->item = item;
-    first->prev = nullptr;
-    first->next = tmp;
-    if (n != 0) tmp->prev = first;
-    n++;
+    linkBefore(nullptr, createItem(std::forward<Args>(args)...));
+}
+
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> ::prepend(const value_type& item)
+{
+    linkBefore(first, createItem(item));
+}
+
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> ::prepend(value_type&& item)
+{
+    linkBefore(first, createItem(std::move(item)));
+}
+
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+template <typename... Args>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: emplacePrepend(Args&&... args)
+{
+    linkBefore(first, createItem(std::forward<Args>(args)...));
+}
+
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: insert(const const_iterator& insertPosition, const value_type& item)
+{
+    linkBefore(insertPosition.GetNode(), createItem(item));
 }
 
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: insert(const const_iterator& insertPosition, value_type&& item)
+{
+    linkBefore(insertPosition.GetNode(), createItem(std::move(item)));
+}
 
-template <class value_type>
-void LinkedList <value_type> :: insert(const const_iterator& insertPosition, const value_type& item)
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+template <typename... Args>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: emplace(const const_iterator& position, Args&&... args)
 {
-    Item* tmp, *inserted, *prev;
-    tmp = insertPosition.GetNode();
+    linkBefore(position.GetNode(), createItem(std::forward<Args>(args)...));
+}
 
-    inserted = new Item;
-    inserted->item = item;
 
-    if (tmp == first)
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+template <typename InputIterator>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: appendRange(InputIterator firstItem, InputIterator lastItem)
+{
+    insert(cend(), firstItem, lastItem);
+}
+
+// builds the whole chain off the list, then links it in with a single relink
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+template <typename InputIterator>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: insert(const const_iterator& insertPosition, InputIterator firstItem, InputIterator lastItem)
+{
+    Item *head = nullptr, *tail = nullptr;
+    int count = 0;
+    try
     {
-        prepend(item);
-        return;
+        for (; firstItem != lastItem; ++firstItem, ++count)
+        {
+            Item* node = createItem(*firstItem);
+            node->prev = tail;
+            if (tail != nullptr) tail->next = node;
+            else head = node;
+            tail = node;
+        }
     }
-
-    if (tmp == nullptr ) //insertPosition = end or empty list
+    catch (...)
     {
-        append(item);
-        return;
+        while (head != nullptr)
+        {
+            Item* tmp = head->next;
+            destroyItem(head);
+            head = tmp;
+        }
+        throw;
     }
+    if (count == 0) return;
 
-    prev = tmp->prev;
-    tmp->prev = inserted;
-    inserted->next = tmp;
-
-    prev->next = inserted;
-    inserted->prev = prev;
-     n++;
+    linkRunBefore(insertPosition.GetNode(), head, tail, count);
+}
 
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: insert(const const_iterator& insertPosition, std::initializer_list<value_type> l)
+{
+    insert(insertPosition, l.begin(), l.end());
 }
 
 
-template <class value_type>
-value_type LinkedList <value_type> :: popFirst()
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+value_type LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: popFirst()
 {
     Item *tmp;
-    value_type item;
     if (n==0) throw std::logic_error("list is empty");
+    tmp = first;
+    fingerUnlinking(tmp);
+    value_type item = std::move(tmp->item);
+    first = tmp->next;
+    if (first != nullptr) first->prev = nullptr;
+    else last = nullptr;
+    destroyItem(tmp);
     n--;
-    tmp =first;
-    item = first->item;
-    first = first->next;
-    delete tmp;
     return item;
 }
-template <class value_type>
-value_type LinkedList <value_type> :: popLast()
+
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+value_type LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: popLast()
 {
     Item *tmp;
-    value_type item;
     if (n==0) throw std::logic_error("list is empty");
-    n--;
-
-    item = last->item;
     tmp = last;
-
-
+    fingerUnlinking(tmp);
+    value_type item = std::move(tmp->item);
     last = tmp->prev;
     if (last != nullptr) last->next = nullptr;
-    delete tmp;
+    else first = nullptr;
+    destroyItem(tmp);
+    n--;
     return item;
 }
 
-template <class value_type>
- void LinkedList<value_type>:: erase(const const_iterator& possition)
- {
-
-    Item* node, *tmp;
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: erase(const const_iterator& possition)
+{
+    Item* node;
     node = possition.GetNode();
     if (node == nullptr) throw std:: out_of_range("");
+    fingerUnlinking(node);
+
+    if (node->prev != nullptr) node->prev->next = node->next;
+    else first = node->next;
+    if (node->next != nullptr) node->next->prev = node->prev;
+    else last = node->prev;
+    destroyItem(node);
     n--;
-    if (n==0)
-    {
-        first = nullptr;
-        last = nullptr;
-        return;
-    }
+}
+
 
-    if (node ==first)
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+{
+    Item* node = firstIncluded.GetNode();
+    Item* stop = lastExcluded.GetNode();
+    if (node == stop) return;
+    if (node == nullptr) throw std::out_of_range("");
+    unlinkRun(node, stop == nullptr ? last : stop->prev);
+    finger = nullptr;
+    while (node != nullptr)
     {
-        tmp = first;
-        first = first->next;
-        delete tmp;
-        first->prev =nullptr;
-        return;
+        Item* tmp = node->next;
+        destroyItem(node);
+        n--;
+        node = tmp;
     }
-    if (node == last)
+}
+
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: splice(const const_iterator& position, LinkedList& other)
+{
+    if (&other == this || other.n == 0) return;
+    allocator.share(other.allocator);
+    Item* head = other.first;
+    Item* tail = other.last;
+    size_type count = other.n;
+    other.first = nullptr;
+    other.last = nullptr;
+    other.n = 0;
+    other.finger = nullptr;
+    linkRunBefore(position.GetNode(), head, tail, count);
+}
+
+// O(1) when both ends are begin, end or the finger of other, otherwise the
+// moved items are counted
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: splice(const const_iterator& position, LinkedList& other,
+                                                     const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+{
+    Item* head = firstIncluded.GetNode();
+    Item* stop = lastExcluded.GetNode();
+    if (head == stop) return;
+    if (head == nullptr) throw std::out_of_range("");
+    Item* tail = stop == nullptr ? other.last : stop->prev;
+
+    size_type count = 0, from, to;
+    if (&other != this)
     {
-        tmp = last;
-        last = last->prev;
-        delete tmp;
-        last->next = nullptr;
-        return;
+        if (other.indexOf(head, from) && other.indexOf(stop, to)) count = to - from;
+        else
+            for (Item* node = head; node != stop; node = node->next) count++;
+        allocator.share(other.allocator);
     }
+    other.unlinkRun(head, tail);
+    other.n -= count;
+    other.finger = nullptr;
+    linkRunBefore(position.GetNode(), head, tail, count);
+}
 
-    tmp = node->prev;
-    tmp->next = node->next;
-    node->next->prev = tmp;
-    delete node;
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: splitAt(const const_iterator& position)
+{
+    LinkedList rest;
+    Item* head = position.GetNode();
+    if (head == nullptr) return rest;
 
- }
+    size_type index;
+    if (!indexOf(head, index))
+    {
+        index = n;
+        for (Item* node = head; node != nullptr; node = node->next) index--;
+    }
+    rest.allocator.share(allocator);
+    rest.first = head;
+    rest.last = last;
+    rest.n = n - index;
+    unlinkRun(head, last);
+    n = index;
+    if (finger != nullptr && fingerIndex >= index) finger = nullptr;
+    return rest;
+}
 
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: concat(LinkedList& other)
+{
+    splice(cend(), other);
+}
 
-template <class value_type>
-void LinkedList<value_type>:: erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+// Merges the sorted chain later into the sorted chain into; both are linked
+// through next only and end in nullptr. Equal items keep into's first. If
+// compare throws, into is left holding every node of both before rethrowing.
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+template <typename Compare>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: mergeChains(Item*& into, Item* later, Compare& compare)
 {
-    Item* node1, *node2, *tmp, *current;
-    node1 = firstIncluded.GetNode();
-    node2 = lastExcluded.GetNode();
-    if (node1 == node2) return;
-    if (node1 == first)
+    Item* earlier = into;
+    Item** tail = &into;
+    try
     {
-    for (auto it = firstIncluded; it != lastExcluded; it++)
-        erase(begin());
-    return;
+        while (earlier != nullptr && later != nullptr)
+        {
+            if (compare(later->item, earlier->item))
+            {
+                *tail = later;
+                later = later->next;
+            }
+            else
+            {
+                *tail = earlier;
+                earlier = earlier->next;
+            }
+            tail = &(*tail)->next;
+        }
     }
+    catch (...)
+    {
+        *tail = earlier;
+        while (*tail != nullptr) tail = &(*tail)->next;
+        *tail = later;
+        throw;
+    }
+    *tail = earlier != nullptr ? earlier : later;
+}
 
-    tmp = node1->prev;
-
-    if (node2 == nullptr && n!= 0)
+// runs[k] holds a sorted chain of 2^k items or nothing, like the digits of a
+// binary counter. Items taken later sit in lower runs, so merging into the
+// higher run keeps the sort stable. Every node is always reachable from
+// exactly one of rest, carry and runs, which is what the catch relies on.
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+template <typename Compare>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: sort(Compare compare)
+{
+    if (n < 2) return;
+    Item* runs[64] = {};
+    Item* rest = first;
+    Item* carry = nullptr;
+    try
     {
-        last = tmp;
-        last->next =nullptr;
+        while (rest != nullptr)
+        {
+            carry = rest;
+            rest = rest->next;
+            carry->next = nullptr;
+            std::size_t k = 0;
+            for (; runs[k] != nullptr; k++)
+            {
+                Item* later = carry;
+                carry = nullptr;
+                mergeChains(runs[k], later, compare);
+                carry = runs[k];
+                runs[k] = nullptr;
+            }
+            runs[k] = carry;
+            carry = nullptr;
+        }
+        for (Item*& run : runs)
+            if (run != nullptr)
+            {
+                Item* later = carry;
+                carry = nullptr;
+                mergeChains(run, later, compare);
+                carry = run;
+                run = nullptr;
+            }
     }
-    else
+    catch (...)
     {
-        tmp->next = node2;
-        node2->prev = tmp;
+        for (Item* run : runs)
+            if (run != nullptr)
+            {
+                Item* end = run;
+                while (end->next != nullptr) end = end->next;
+                end->next = rest;
+                rest = run;
+            }
+        first = rest;
+        relinkPrevious();
+        throw;
     }
+    first = carry;
+    relinkPrevious();
+}
 
-    current = node1;
-    for (auto it = firstIncluded; it != lastExcluded; it++)
+// rebuilds prev and last from the next links after a sort
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void LinkedList <value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: relinkPrevious()
+{
+    finger = nullptr;
+    Item* previous = nullptr;
+    for (Item* node = first; node != nullptr; node = node->next)
     {
-        current = current->next;
-        delete node1;
-        node1 = current;
-        n--;
+        node->prev = previous;
+        previous = node;
     }
+    last = previous;
 }
 
-
-template <class value_type>
-LinkedList<value_type>& LinkedList<value_type> :: operator=(LinkedList&& other)
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+LinkedList<value_type, NodeAllocator, Instrumentation, Checking, Indexing>& LinkedList<value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: operator=(LinkedList&& other)
 {
+    if (this == &other) return *this;
+    clear();
     first = other.first;
     last = other.last;
     n = other.n;
+    finger = other.finger;
+    fingerIndex = other.fingerIndex;
+    allocator.swap(other.allocator);
     other.first = nullptr;
     other.last = nullptr;
     other.n = 0;
+    other.finger = nullptr;
     return *this;
 }
 
-template <class value_type>
-LinkedList<value_type>& LinkedList<value_type> :: operator=(const LinkedList& other)
+template <class value_type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+LinkedList<value_type, NodeAllocator, Instrumentation, Checking, Indexing>& LinkedList<value_type, NodeAllocator, Instrumentation, Checking, Indexing> :: operator=(const LinkedList& other)
 {
-    Item *current, *current_other, *tmp;
-    n = other.n;
-    if (other.n == 0)
-    {
-        first = nullptr;
-        last = nullptr;
-        return *this;
-    }
-    current_other = other.first;
-    first = new Item;
-    first->prev = nullptr;
-    current = first;
-    while (current_other != other.last)
-    {
-       current->item = current_other->item;
-       current->next = new Item;
-       tmp = current;
-       current = current->next;
-       current->prev = tmp;
-       current_other = current_other->next;
-    }
-    current->item = current_other->item;
-    current->next = nullptr;
-    last = current;
-
+    if (this == &other) return *this;
+    clear();
+    for (Item* current = other.first; current != nullptr; current = current->next)
+        append(current->item);
     return *this;
 }
 
-
-
-
 }
 #endif // AISDI_LINEAR_LINKEDLIST_H
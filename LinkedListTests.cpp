@@ -0,0 +1,1341 @@
+#include <LinkedList.h>
+#include <PersistentList.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <complex>
+#include <functional>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <boost/mpl/list.hpp>
+
+using TestedTypes = boost::mpl::list<std::int32_t, std::uint64_t, std::complex<std::int32_t>>;
+
+// iterator checks are tested too, so keep them on in release builds as well
+template <typename T>
+using LinearCollection = aisdi::LinkedList<T, aisdi::NodePool, aisdi::NoInstrumentation, aisdi::CheckedIterators>;
+
+using IndexingPolicies = boost::mpl::list<aisdi::NoIndex, aisdi::FingerIndex>;
+
+template <typename T, class Indexing>
+using IndexedCollection = aisdi::LinkedList<T, aisdi::NodePool, aisdi::NoInstrumentation, aisdi::CheckedIterators, Indexing>;
+
+template <class Indexing>
+using CountedCollection = aisdi::LinkedList<int, aisdi::NodePool, aisdi::CountingInstrumentation, aisdi::CheckedIterators, Indexing>;
+
+using std::begin;
+using std::end;
+
+BOOST_AUTO_TEST_SUITE(LinkedListTests)
+
+
+template <typename T>
+void thenCollectionContainsValues(const LinearCollection<T>& collection,
+                                  std::initializer_list<int> expected)
+{
+  BOOST_CHECK_EQUAL_COLLECTIONS(begin(collection), end(collection),
+                                begin(expected), end(expected));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenCreatedWithDefaultConstructor_ThenItIsEmpty,
+                              T,
+                            TestedTypes)
+{
+  const LinearCollection<T> collection;
+
+  BOOST_CHECK(collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenAddingItem_ThenItIsNoLongerEmpty,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+
+  collection.append(T{});
+
+  BOOST_CHECK(!collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenGettingIterators_ThenBeginEqualsEnd,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+
+  BOOST_CHECK(begin(collection) == end(collection));
+  BOOST_CHECK(const_cast<const LinearCollection<T>&>(collection).begin() == collection.end());
+  BOOST_CHECK(collection.cbegin() == collection.cend());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenGettingIterator_ThenBeginIsNotEnd,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  collection.append(T{});
+
+  BOOST_CHECK(collection.begin() != collection.end());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollectionWithOneElement_WhenIterating_ThenElementIsReturned,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  collection.append(753);
+
+  auto it = collection.begin();
+
+  BOOST_CHECK_EQUAL(*it, 753);
+  BOOST_CHECK(++it == collection.end());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenIterator_WhenPostIncrementing_ThenPreviousPositionIsReturned,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  collection.append(T{});
+
+  auto it = collection.begin();
+  auto postIncrementedIt = it++;
+
+  BOOST_CHECK(postIncrementedIt == collection.begin());
+  BOOST_CHECK(it == collection.end());
+  BOOST_CHECK(postIncrementedIt == collection.cbegin());
+  BOOST_CHECK(it == collection.cend());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenIterator_WhenPreIncrementing_ThenNewPositionIsReturned,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  collection.append(T{});
+
+  auto it = collection.begin();
+  auto preIncrementedIt = ++it;
+
+  BOOST_CHECK(preIncrementedIt == it);
+  BOOST_CHECK(it == collection.end());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEndIterator_WhenIncrementing_ThenOperationThrows,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+
+  BOOST_CHECK_THROW(collection.end()++, std::out_of_range);
+  BOOST_CHECK_THROW(++(collection.end()), std::out_of_range);
+  BOOST_CHECK_THROW(collection.cend()++, std::out_of_range);
+  BOOST_CHECK_THROW(++(collection.cend()), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEndIterator_WhenDecrementing_ThenIteratorPointsToLastItem,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  collection.append(1);
+  collection.append(2);
+
+  auto it = collection.end();
+  --it;
+
+  BOOST_CHECK_EQUAL(*it, 2);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenIterator_WhenPreDecrementing_ThenNewIteratorValueIsReturned,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  collection.append(1);
+
+  auto it = collection.end();
+  auto preDecremented = --it;
+
+  BOOST_CHECK(it == preDecremented);
+  BOOST_CHECK_EQUAL(*it, 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenIterator_WhenPostDecrementing_ThenOldIteratorValueIsReturned,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  collection.append(1);
+
+  auto it = collection.end();
+  auto postDecremented = it--;
+
+  BOOST_CHECK(postDecremented == collection.end());
+  BOOST_CHECK_EQUAL(*it, 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenBeginIterator_WhenDecrementing_ThenOperationThrows,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+
+  BOOST_CHECK_THROW(collection.begin()--, std::out_of_range);
+  BOOST_CHECK_THROW(--(collection.begin()), std::out_of_range);
+  BOOST_CHECK_THROW(collection.cbegin()--, std::out_of_range);
+  BOOST_CHECK_THROW(--(collection.cbegin()), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEndIterator_WhenDereferencing_ThenOperationThrows,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+
+  BOOST_CHECK_THROW(*collection.end(), std::out_of_range);
+  BOOST_CHECK_THROW(*collection.cend(), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenConstIterator_WhenDereferencing_ThenItemIsReturned,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 10, 20, 30 };
+
+  auto it = ++collection.cbegin();
+
+  BOOST_CHECK_EQUAL(*it, 20);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenIterator_WhenDereferencing_ThenItemCanBeChanged,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 10, 20, 30 };
+
+  auto it = ++begin(collection);
+  *it = 500;
+
+  thenCollectionContainsValues(collection, { 10, 500, 30 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenIterator_WhenAddingInteger_ThenAdvancedIteratorIsReturned,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 2001, 2010, 2051 };
+
+  auto it = begin(collection);
+
+  BOOST_CHECK(it + 3 == end(collection));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenIterator_WhenSubstractingInteger_ThenChangedIteratorIsReturned,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 2001, 2010, 2051 };
+
+  auto it = end(collection);
+
+  BOOST_CHECK(it - 2 == ++begin(collection));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenAddingItem_ThenItemIsInCollection,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+
+  collection.append(42);
+
+  thenCollectionContainsValues(collection, { 42 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenInitializingFromList_ThenAllItemsAreInCollection,
+                              T,
+                              TestedTypes)
+{
+  const LinearCollection<T> collection = { 1410, 753, 1789 };
+
+  thenCollectionContainsValues(collection, { 1410, 753, 1789 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenCreatingCopy_ThenAllItemsAreCopied,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1410, 753, 1789 };
+  LinearCollection<T> other{collection};
+
+  collection.append(1024);
+
+  thenCollectionContainsValues(collection, { 1410, 753, 1789, 1024 });
+  thenCollectionContainsValues(other, { 1410, 753, 1789 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenCreatingCopy_ThenBothCollectionsAreEmpty,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  LinearCollection<T> other{collection};
+
+  BOOST_CHECK(other.isEmpty());
+  BOOST_CHECK(collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenMovingToOther_ThenAllItemsAreMoved,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1410, 753, 1789 };
+  LinearCollection<T> other{std::move(collection)};
+
+  thenCollectionContainsValues(other, { 1410, 753, 1789 });
+  BOOST_CHECK(collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenMovingToOther_ThenBothCollectionsAreEmpty,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  LinearCollection<T> other{std::move(collection)};
+
+  BOOST_CHECK(other.isEmpty());
+  BOOST_CHECK(collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenAssigningToOther_ThenAllElementsAreCopied,
+                              T,
+                              TestedTypes)
+{
+  const LinearCollection<T> collection = { 1, 2, 3, 4 };
+  LinearCollection<T> other = { 100, 200, 300, 400 };
+
+  other = collection;
+
+  thenCollectionContainsValues(other, { 1, 2, 3, 4 });
+  thenCollectionContainsValues(collection, { 1, 2, 3, 4 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenAssigningToOther_ThenOtherCollectionIsEmpty,
+                              T,
+                              TestedTypes)
+{
+  const LinearCollection<T> collection;
+  LinearCollection<T> other = { 100, 200, 300, 400 };
+
+  other = collection;
+
+  BOOST_CHECK(other.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenMoveAssigning_ThenAllElementsAreMoved,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1, 2, 3, 4 };
+  LinearCollection<T> other = { 100, 200, 300, 400 };
+
+  other = std::move(collection);
+
+  thenCollectionContainsValues(other, { 1, 2, 3, 4 });
+  BOOST_CHECK(collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenMoveAssigning_ThenBothCollectionAreEmpty,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  LinearCollection<T> other = { 100, 200, 300, 400 };
+
+  other = std::move(collection);
+
+  BOOST_CHECK(other.isEmpty());
+  BOOST_CHECK(collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenAppendingItem_ThenItemIsLast,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1, 2, 3 };
+
+  collection.append(42);
+
+  thenCollectionContainsValues(collection, { 1, 2, 3, 42 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenPrependingItem_ThenItemIsAdded,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+
+  collection.prepend(300);
+
+  thenCollectionContainsValues(collection, { 300 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenPrependingItem_ThenItemIsFirst,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1, 2 };
+
+  collection.prepend(300);
+
+  thenCollectionContainsValues(collection, { 300, 1, 2 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenGettingSize_ThenZeroIsReturned,
+                              T,
+                              TestedTypes)
+{
+  const LinearCollection<T> collection;
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenGettingSize_ThenElementCountIsReturned,
+                              T,
+                              TestedTypes)
+{
+  const LinearCollection<T> collection = { 12, 100, 500 };
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 3);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenChangingIt_ThenItsSizeAlsoChanges,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 72, 27, 77 };
+  collection.append(99);
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 4);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenPrependingItem_ThenSizeIsUpdated,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 72, 27, 77 };
+  collection.prepend(99);
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 4);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenInsertingItem_ThenItemIsAdded,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+
+  collection.insert(begin(collection), 42);
+
+  thenCollectionContainsValues(collection, { 42 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenInsertingAtBegin_ThenItemIsPrepended,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 11, 12, 13 };
+
+  collection.insert(begin(collection), 42);
+
+  thenCollectionContainsValues(collection, { 42, 11, 12, 13 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenInsertingAtEnd_ThenItemIsAppended,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 11, 12, 13 };
+
+  collection.insert(end(collection), 42);
+
+  thenCollectionContainsValues(collection, { 11, 12, 13, 42 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenInsertingInMiddle_ThenItemInserted,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 11, 12, 13 };
+
+  collection.insert(++begin(collection), 42);
+
+  thenCollectionContainsValues(collection, { 11, 42, 12, 13 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenInserting_ThenSizeIsUpdated,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 101, 102, 103 };
+
+  collection.insert(begin(collection), 27);
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 4);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenPoppingFirst_ThenOperationThrows,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+
+  BOOST_CHECK_THROW(collection.popFirst(), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenPoppingLast_ThenOperationThrows,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+
+  BOOST_CHECK_THROW(collection.popLast(), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollectionWithSingleItem_WhenPoppingFirst_ThenCollectionIsEmpty,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 420 };
+
+  collection.popFirst();
+
+  BOOST_CHECK(collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollectionWithSingleItem_WhenPoppingLast_ThenCollectionIsEmpty,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 420 };
+
+  collection.popLast();
+
+  BOOST_CHECK(collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenPoppingFirst_ThenCollectionSizeIsReduced,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 14, 10 };
+
+  collection.popFirst();
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenPoppingLast_ThenCollectionSizeIsReduced,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 14, 10 };
+
+  collection.popLast();
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenPoppingFirst_ThenItemIsRemoved,
+                              T,
+                         TestedTypes)
+{
+  LinearCollection<T> collection = { 300, 8, 480 };
+
+  collection.popFirst();
+
+  thenCollectionContainsValues(collection, { 8, 480 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenPoppingLast_ThenItemIsRemoved,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 300, 8, 480 };
+
+  collection.popLast();
+
+  thenCollectionContainsValues(collection, { 300, 8 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenPoppingFirst_ThenItemsIsReturned,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 101, 202, 303 };
+
+  BOOST_CHECK_EQUAL(collection.popFirst(), 101);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenPoppingLast_ThenItemsIsReturned,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 101, 202, 303 };
+
+  BOOST_CHECK_EQUAL(collection.popLast(), 303);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenErasing_ThenOperationThrows,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+
+  BOOST_CHECK_THROW(collection.erase(collection.begin()), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenErasingEnd_ThenOperationThrows,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 20, 16 };
+
+  BOOST_CHECK_THROW(collection.erase(end(collection)), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenErasingBegin_ThenItemIsRemoved,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 22, 41, 31 };
+
+  collection.erase(begin(collection));
+
+  thenCollectionContainsValues(collection, { 41, 31 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenErasingLastItem_ThemItemIsRemoved,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 22, 45, 33 };
+
+  collection.erase(--end(collection));
+
+  thenCollectionContainsValues(collection, { 22, 45 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenErasingMiddleItem_ThenItemIsRemoved,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 22, 51, 48 };
+
+  collection.erase(++begin(collection));
+
+  thenCollectionContainsValues(collection, { 22, 48 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenErasing_ThenSizeIsReduced,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1000, 500, 2, 900 };
+
+  collection.erase(begin(collection) + 2);
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 3);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollectionWithSingleItem_WhenErasing_ThenCollectionIsEmpty,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1529 };
+
+  collection.erase(begin(collection));
+
+  BOOST_CHECK(collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenErasingEmptyRange_ThenNothingHappens,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 19, 42, 11 };
+
+  collection.erase(begin(collection), begin(collection));
+
+  thenCollectionContainsValues(collection, { 19, 42, 11 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenErasingRangeFromBegin_ThenItemsAreRemoved,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 19, 42, 11 };
+
+  collection.erase(begin(collection), begin(collection) + 2);
+
+  thenCollectionContainsValues(collection, { 11 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_whenErasingRangeToEnd_ThenItemsAreRemoved,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 20, 1, 45 };
+
+  collection.erase(begin(collection) + 1, end(collection));
+
+  thenCollectionContainsValues(collection, { 20 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenErasingSingleItemRange_ThenItemIsRemoved,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 2001, 2010, 2051, 3001 };
+
+  collection.erase(begin(collection) + 1, begin(collection) + 2);
+
+  thenCollectionContainsValues(collection, { 2001, 2051, 3001 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenErasingWholeRange_ThenCollectinIsEmpty,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 400, 403, 404 };
+
+  collection.erase(begin(collection), end(collection));
+
+  BOOST_CHECK(collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenErasingRange_ThenSizeIsUpdated,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 23, 10, 20, 16 };
+
+  collection.erase(begin(collection) + 1, end(collection) - 1);
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 2);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenInsertingRangeInMiddle_ThenItemsAreInOrder,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1, 2, 6 };
+  const std::vector<T> items = { 3, 4, 5 };
+
+  collection.insert(begin(collection) + 2, items.begin(), items.end());
+
+  thenCollectionContainsValues(collection, { 1, 2, 3, 4, 5, 6 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenAppendingRange_ThenItemsAreLast,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1 };
+  const std::vector<T> items(100, T{7});
+
+  collection.appendRange(items.begin(), items.end());
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 101);
+  BOOST_CHECK_EQUAL(*begin(collection), T{1});
+  BOOST_CHECK_EQUAL(*(end(collection) - 1), T{7});
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenInsertingInitializerList_ThenItemsArePrepended,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 3 };
+
+  collection.insert(begin(collection), { 1, 2 });
+  collection.insert(end(collection), {});
+
+  thenCollectionContainsValues(collection, { 1, 2, 3 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenInsertingSinglePassRange_ThenItemsAreInserted)
+{
+  LinearCollection<int> collection = { 1, 5 };
+  std::istringstream stream("2 3 4");
+
+  collection.insert(begin(collection) + 1, std::istream_iterator<int>(stream), std::istream_iterator<int>());
+
+  thenCollectionContainsValues(collection, { 1, 2, 3, 4, 5 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenUninstrumentedCollection_WhenMeasuringSize_ThenNoCountersAreStored)
+{
+  BOOST_CHECK_EQUAL(sizeof(aisdi::LinkedList<int>),
+                    sizeof(aisdi::LinkedList<int, aisdi::NodePool, aisdi::CountingInstrumentation>)
+                    - sizeof(aisdi::InstrumentationCounters));
+}
+
+BOOST_AUTO_TEST_CASE(GivenInstrumentedCollection_WhenAddingAndRemoving_ThenNodesAreCounted)
+{
+  aisdi::LinkedList<int, aisdi::NodePool, aisdi::CountingInstrumentation> collection = { 1, 2, 3, 4 };
+
+  collection.popFirst();
+  collection.erase(begin(collection) + 1);
+  for (auto it = collection.begin(); it != collection.end(); ++it) {}
+
+  const auto counters = collection.getInstrumentation().getCounters();
+  BOOST_CHECK_EQUAL(counters.nodeAllocations, 4);
+  BOOST_CHECK_EQUAL(counters.nodeFrees, 2);
+  BOOST_CHECK_EQUAL(counters.iteratorSteps, 1 + 2);
+}
+
+BOOST_AUTO_TEST_CASE(GivenInstrumentedCollection_WhenConstructorThrows_ThenNoNodeIsCounted)
+{
+  aisdi::LinkedList<std::string, aisdi::NodePool, aisdi::CountingInstrumentation> collection = { "a" };
+
+  // std::string(other, pos) throws for pos past the end of other
+  BOOST_CHECK_THROW(collection.emplaceAppend(std::string("ab"), 5), std::out_of_range);
+
+  const auto counters = collection.getInstrumentation().getCounters();
+  BOOST_CHECK_EQUAL(counters.nodeAllocations, 1);
+  BOOST_CHECK_EQUAL(counters.nodeFrees, 0);
+  BOOST_CHECK_EQUAL(collection.getSize(), 1);
+}
+
+// Wraps a string and counts how often instances get copied or moved.
+struct CountedString
+{
+  static int copies;
+  static int moves;
+
+  std::string value;
+
+  CountedString(const char* text) : value(text) {}
+  CountedString(const CountedString& other) : value(other.value) { ++copies; }
+  CountedString(CountedString&& other) noexcept : value(std::move(other.value)) { ++moves; }
+
+  CountedString& operator=(const CountedString& other)
+  {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+
+  CountedString& operator=(CountedString&& other) noexcept
+  {
+    value = std::move(other.value);
+    ++moves;
+    return *this;
+  }
+
+  static void reset()
+  {
+    copies = 0;
+    moves = 0;
+  }
+};
+
+int CountedString::copies = 0;
+int CountedString::moves = 0;
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenMovingItemsThrough_ThenNothingIsCopied)
+{
+  LinearCollection<CountedString> collection;
+  CountedString::reset();
+
+  for (int i = 0; i < 100; ++i)
+  {
+    CountedString item("some string long enough to live on the heap");
+    collection.append(std::move(item));
+  }
+  CountedString item("prepended");
+  collection.prepend(std::move(item));
+  CountedString other("inserted");
+  collection.insert(begin(collection) + 50, std::move(other));
+  CountedString first = collection.popFirst();
+  CountedString last = collection.popLast();
+
+  BOOST_CHECK_EQUAL(CountedString::copies, 0);
+  BOOST_CHECK_EQUAL(first.value, "prepended");
+  BOOST_CHECK_EQUAL((*(begin(collection) + 49)).value, "inserted");
+  BOOST_CHECK_EQUAL(collection.getSize(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenEmplacing_ThenItemsAreBuiltInPlace)
+{
+  LinearCollection<CountedString> collection;
+  CountedString::reset();
+
+  collection.emplaceAppend("b");
+  collection.emplacePrepend("a");
+  collection.emplace(end(collection), "c");
+
+  BOOST_CHECK_EQUAL(CountedString::copies, 0);
+  BOOST_CHECK_EQUAL((*begin(collection)).value, "a");
+  BOOST_CHECK_EQUAL((*(begin(collection) + 1)).value, "b");
+  BOOST_CHECK_EQUAL((*(begin(collection) + 2)).value, "c");
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenAppendingCopy_ThenItemIsCopiedOnce)
+{
+  LinearCollection<CountedString> collection;
+  CountedString item("copied");
+  CountedString::reset();
+
+  collection.append(item);
+
+  BOOST_CHECK_EQUAL(CountedString::copies, 1);
+  BOOST_CHECK_EQUAL(item.value, "copied");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenInsertingAndErasingAtOffsets_ThenItMatchesVector,
+                              Indexing,
+                              IndexingPolicies)
+{
+  IndexedCollection<int, Indexing> collection;
+  std::vector<int> expected;
+  unsigned seed = 7;
+  auto next = [&seed](std::size_t bound) {
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<std::size_t>(seed >> 8) % bound;
+  };
+
+  for (int i = 0; i < 2000; ++i)
+  {
+    const std::size_t offset = next(expected.size() + 1);
+    switch (next(5))
+    {
+    case 0:
+      collection.insert(begin(collection) + offset, i);
+      expected.insert(expected.begin() + offset, i);
+      break;
+    case 1:
+      collection.insert(end(collection) - (expected.size() - offset), i);
+      expected.insert(expected.begin() + offset, i);
+      break;
+    case 2:
+      if (offset == expected.size()) break;
+      collection.erase(begin(collection) + offset);
+      expected.erase(expected.begin() + offset);
+      break;
+    case 3:
+      collection.prepend(i);
+      expected.insert(expected.begin(), i);
+      break;
+    default:
+      if (offset == expected.size()) break;
+      BOOST_REQUIRE_EQUAL(*(begin(collection) + offset), expected[offset]);
+      if (offset + 1 < expected.size()) collection.popLast(), expected.pop_back();
+      else collection.popFirst(), expected.erase(expected.begin());
+    }
+  }
+
+  BOOST_CHECK_EQUAL_COLLECTIONS(begin(collection), end(collection), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(GivenFingerIndex_WhenMovingToNearbyOffsets_ThenOnlyTheDistanceIsWalked)
+{
+  CountedCollection<aisdi::FingerIndex> collection;
+  for (int i = 0; i < 1000; ++i)
+    collection.append(i);
+
+  BOOST_CHECK_EQUAL(*(begin(collection) + 400), 400);
+  const std::size_t stepsBefore = collection.getInstrumentation().getCounters().iteratorSteps;
+  BOOST_CHECK_EQUAL(*(begin(collection) + 403), 403);
+  collection.insert(begin(collection) + 403, -1);
+  BOOST_CHECK_EQUAL(*(end(collection) - 599), 402);
+  BOOST_CHECK_EQUAL(*(end(collection) - 1), 999);
+
+  BOOST_CHECK_EQUAL(collection.getInstrumentation().getCounters().iteratorSteps - stepsBefore, 3 + 0 + 1 + 0);
+}
+
+BOOST_AUTO_TEST_CASE(GivenNoIndex_WhenMovingToOffsets_ThenTheWalkStartsAtTheNearerEnd)
+{
+  CountedCollection<aisdi::NoIndex> collection;
+  for (int i = 0; i < 1000; ++i)
+    collection.append(i);
+  const auto& constCollection = collection;
+
+  const std::size_t stepsBefore = collection.getInstrumentation().getCounters().iteratorSteps;
+  BOOST_CHECK_EQUAL(*(constCollection.cbegin() + 400), 400);
+  BOOST_CHECK_EQUAL(*(constCollection.cbegin() + 403), 403);
+  BOOST_CHECK_EQUAL(*(constCollection.cend() - 100), 900);
+
+  BOOST_CHECK_EQUAL(collection.getInstrumentation().getCounters().iteratorSteps - stepsBefore, 400 + 403 + 99);
+}
+
+// Meant to be run under ThreadSanitizer too: without an index, offsets on a
+// const list only read it.
+BOOST_AUTO_TEST_CASE(GivenConstList_WhenReadAtOffsetsOnTwoThreads_ThenBothSeeTheItems)
+{
+  LinearCollection<int> collection;
+  for (int i = 0; i < 1000; ++i) collection.append(i);
+  const LinearCollection<int>& constCollection = collection;
+  auto read = [&constCollection](int start, bool& valid) {
+    for (int k = start; k < 1000; k += 7)
+      if (*(constCollection.cbegin() + k) != k) valid = false;
+  };
+
+  bool firstValid = true, secondValid = true;
+  std::thread first(read, 0, std::ref(firstValid));
+  std::thread second(read, 3, std::ref(secondValid));
+  first.join();
+  second.join();
+
+  BOOST_CHECK(firstValid);
+  BOOST_CHECK(secondValid);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenTwoCollections_WhenSplicingWholeOther_ThenItemsAreMoved,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1, 4 };
+  LinearCollection<T> other = { 2, 3 };
+
+  collection.splice(begin(collection) + 1, other);
+
+  thenCollectionContainsValues(collection, { 1, 2, 3, 4 });
+  BOOST_CHECK(other.isEmpty());
+  BOOST_CHECK(begin(other) == end(other));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenTwoCollections_WhenSplicingRange_ThenOnlyRangeIsMoved,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1, 5 };
+  LinearCollection<T> other = { 0, 2, 3, 4, 6 };
+
+  collection.splice(begin(collection) + 1, other, begin(other) + 1, end(other) - 1);
+
+  thenCollectionContainsValues(collection, { 1, 2, 3, 4, 5 });
+  thenCollectionContainsValues(other, { 0, 6 });
+  BOOST_CHECK_EQUAL(other.getSize(), 2);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenSplicingRangeWithinItself_ThenItemsAreReordered,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 3, 4, 1, 2 };
+  auto middle = begin(collection) + 2;
+
+  collection.splice(begin(collection), collection, middle, end(collection));
+
+  thenCollectionContainsValues(collection, { 1, 2, 3, 4 });
+  BOOST_CHECK_EQUAL(collection.getSize(), 4);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenSplittingAndConcatenating_ThenItemsAreKept,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1, 2, 3, 4, 5 };
+
+  LinearCollection<T> rest = collection.splitAt(begin(collection) + 2);
+
+  thenCollectionContainsValues(collection, { 1, 2 });
+  thenCollectionContainsValues(rest, { 3, 4, 5 });
+  BOOST_CHECK_EQUAL(*(end(collection) - 1), T{2});
+
+  rest.concat(collection);
+
+  thenCollectionContainsValues(rest, { 3, 4, 5, 1, 2 });
+  BOOST_CHECK(collection.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(GivenSplicedItems_WhenSourceCollectionIsDestroyed_ThenItemsStayUsable)
+{
+  LinearCollection<std::string> collection = { "a" };
+  {
+    LinearCollection<std::string> source = { "b", "c", "d" };
+    collection.splice(end(collection), source, begin(source), end(source) - 1);
+    source.append("e");
+  }
+
+  collection.append("f");
+  collection.erase(begin(collection) + 1);
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 3);
+  BOOST_CHECK_EQUAL(*(begin(collection) + 1), "c");
+  BOOST_CHECK_EQUAL(*(end(collection) - 1), "f");
+}
+
+BOOST_AUTO_TEST_CASE(GivenInstrumentedCollections_WhenSplicing_ThenNoNodesAreAllocated)
+{
+  aisdi::LinkedList<int, aisdi::NodePool, aisdi::CountingInstrumentation> collection = { 1, 2 };
+  aisdi::LinkedList<int, aisdi::NodePool, aisdi::CountingInstrumentation> other = { 3, 4, 5 };
+
+  collection.concat(other);
+  auto rest = collection.splitAt(begin(collection) + 1);
+  collection.erase(begin(collection), end(collection));
+
+  const auto counters = collection.getInstrumentation().getCounters();
+  BOOST_CHECK_EQUAL(counters.nodeAllocations, 2);
+  BOOST_CHECK_EQUAL(counters.nodeFrees, 1);
+  BOOST_CHECK_EQUAL(rest.getSize(), 4);
+}
+
+// Meant to be run under ThreadSanitizer too: the split lists share one node
+// pool, which each thread allocates from and frees to.
+BOOST_AUTO_TEST_CASE(GivenListsSplitFromOne_WhenChangedOnTwoThreads_ThenBothStayIntact)
+{
+  LinearCollection<int> collection;
+  for (int i = 0; i < 1000; ++i) collection.append(i);
+  LinearCollection<int> rest = collection.splitAt(begin(collection) + 500);
+  LinearCollection<int> third = { 7 };
+  third.concat(rest);
+  auto churn = [](LinearCollection<int>& list) {
+    for (int round = 0; round < 20000; ++round)
+    {
+      list.append(round);
+      list.erase(begin(list));
+    }
+  };
+
+  std::thread other(churn, std::ref(third));
+  churn(collection);
+  other.join();
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 500);
+  BOOST_CHECK_EQUAL(third.getSize(), 501);
+  BOOST_CHECK_EQUAL(*begin(collection), 20000 - 500);
+  BOOST_CHECK_EQUAL(*(end(third) - 1), 19999);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenSorting_ThenEqualItemsKeepTheirOrderAndNodes)
+{
+  std::mt19937 random(18);
+  for (int size : { 0, 1, 2, 3, 7, 64, 1000 })
+  {
+    LinearCollection<std::pair<int, int>> collection;
+    std::vector<std::pair<int, int>> expected;
+    for (int i = 0; i < size; ++i)
+      expected.push_back({ int(random() % 10), i });
+    collection.appendRange(expected.begin(), expected.end());
+    std::vector<const std::pair<int, int>*> nodes;
+    for (auto& item : collection) nodes.push_back(&item);
+
+    auto byKey = [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; };
+    collection.sort(byKey);
+    std::stable_sort(expected.begin(), expected.end(), byKey);
+
+    BOOST_REQUIRE(std::equal(begin(collection), end(collection), expected.begin(), expected.end()));
+    BOOST_CHECK(std::equal(expected.rbegin(), expected.rend(), std::make_reverse_iterator(end(collection))));
+    for (auto& item : collection)
+      BOOST_CHECK_EQUAL(&item, nodes[item.second]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(GivenThrowingComparison_WhenSorting_ThenNoItemIsLost)
+{
+  LinearCollection<int> collection;
+  for (int i = 0; i < 100; ++i) collection.append((i * 37) % 100);
+  int comparisons = 0;
+
+  BOOST_CHECK_THROW(collection.sort([&](int a, int b) {
+    if (++comparisons == 300) throw std::runtime_error("failed");
+    return a < b;
+  }), std::runtime_error);
+
+  std::vector<int> items(begin(collection), end(collection));
+  std::sort(items.begin(), items.end());
+  BOOST_CHECK_EQUAL(collection.getSize(), 100);
+  for (int i = 0; i < 100; ++i) BOOST_CHECK_EQUAL(items[i], i);
+  collection.sort(std::greater<int>());
+  BOOST_CHECK_EQUAL(*begin(collection), 99);
+  BOOST_CHECK_EQUAL(*(end(collection) - 1), 0);
+}
+
+BOOST_AUTO_TEST_CASE(GivenPersistentList_WhenPrepending_ThenOlderVersionsAreUnchanged)
+{
+  const aisdi::PersistentList<int> base = { 2, 3 };
+  const auto one = base.prepend(1);
+  const auto other = base.prepend(9).prepend(8);
+
+  BOOST_CHECK_EQUAL(base.getSize(), 2);
+  BOOST_CHECK_EQUAL(one.getSize(), 3);
+  BOOST_CHECK_EQUAL(other.front(), 8);
+  BOOST_CHECK(one.rest().isSameAs(base));
+  BOOST_CHECK(other.rest().rest().isSameAs(base));
+
+  const std::vector<int> expected = { 1, 2, 3 };
+  BOOST_CHECK_EQUAL_COLLECTIONS(one.begin(), one.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(GivenEmptyPersistentList_WhenTakingFront_ThenExceptionIsThrown)
+{
+  const aisdi::PersistentList<int> list;
+
+  BOOST_CHECK(list.isEmpty());
+  BOOST_CHECK_THROW(list.front(), std::logic_error);
+  BOOST_CHECK_THROW(list.rest(), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenConvertingToPersistentListAndBack_ThenItemsAreKept)
+{
+  const LinearCollection<int> collection = { 1, 2, 3 };
+
+  const aisdi::PersistentList<int> list(collection);
+  const auto back = list.prepend(0).toLinkedList<LinearCollection<int>>();
+
+  thenCollectionContainsValues(back, { 0, 1, 2, 3 });
+  BOOST_CHECK_EQUAL(list.getSize(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(GivenLongPersistentList_WhenLastVersionIsDropped_ThenNodesAreFreedWithoutRecursion)
+{
+  auto counter = std::make_shared<int>(0);
+  {
+    aisdi::PersistentList<std::shared_ptr<int>> list;
+    for (int i = 0; i < 1000000; ++i) list = list.prepend(counter);
+    const auto shorter = list.rest();
+    list = aisdi::PersistentList<std::shared_ptr<int>>();
+    BOOST_CHECK_EQUAL(counter.use_count(), 1000000);
+  }
+  BOOST_CHECK_EQUAL(counter.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenStreamedInFramesAndReadBack_ThenItemsAreAppended)
+{
+  std::FILE* stream = std::tmpfile();
+  LinearCollection<std::uint64_t> collection;
+  for (std::uint64_t i = 0; i < 20000; ++i) collection.append(i * 3); // a few frames
+  aisdi::writeBinary(fileno(stream), collection);
+  std::rewind(stream);
+
+  LinearCollection<std::uint64_t> read;
+  aisdi::readBinary(fileno(stream), read);
+  std::rewind(stream);
+  aisdi::Vector<std::uint64_t> asVector;
+  BOOST_CHECK_THROW(aisdi::readBinary(fileno(stream), asVector), std::runtime_error);
+  std::fclose(stream);
+
+  BOOST_CHECK_EQUAL(read.getSize(), 20000);
+  BOOST_CHECK(std::equal(begin(collection), end(collection), begin(read)));
+}
+
+BOOST_AUTO_TEST_CASE(GivenStreamCutShortInAFrame_WhenReading_ThenExceptionIsThrownAndNothingIsAppended)
+{
+  std::FILE* stream = std::tmpfile();
+  LinearCollection<std::uint64_t> collection;
+  for (std::uint64_t i = 0; i < 20000; ++i) collection.append(i);
+  aisdi::writeBinary(fileno(stream), collection);
+  // the first frame is whole, the second one ends halfway
+  BOOST_CHECK_EQUAL(ftruncate(fileno(stream), 32 + 4 + 8192 * sizeof(std::uint64_t) + 4 + 100), 0);
+  std::rewind(stream);
+
+  LinearCollection<std::uint64_t> read = { 9 };
+  BOOST_CHECK_THROW(aisdi::readBinary(fileno(stream), read), std::runtime_error);
+  std::fclose(stream);
+
+  thenCollectionContainsValues(read, { 9 });
+}
+
+// ConstIterator is tested via Iterator methods.
+// If Iterator methods are to be changed, then new ConstIterator tests are required.
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// NodePool is what LinkedList allocates its nodes from by default.
+BOOST_AUTO_TEST_SUITE(NodePoolTests)
+
+struct PoolNode
+{
+  void* links[2];
+  long item;
+};
+
+BOOST_AUTO_TEST_CASE(GivenFreedNodes_WhenAllocating_ThenTheirSlotsAreReusedLastFreedFirst)
+{
+  aisdi::NodePool<PoolNode> pool;
+  PoolNode* a = pool.allocate();
+  PoolNode* b = pool.allocate();
+  pool.allocate();
+  const std::size_t slots = pool.getSlotCount();
+
+  pool.deallocate(b);
+  pool.deallocate(a);
+
+  BOOST_CHECK_EQUAL(pool.allocate(), a);
+  BOOST_CHECK_EQUAL(pool.allocate(), b);
+  BOOST_CHECK_EQUAL(pool.getSlotCount(), slots);
+}
+
+BOOST_AUTO_TEST_CASE(GivenPool_WhenItGrows_ThenSlabsDoubleUpToTheirCap)
+{
+  aisdi::NodePool<PoolNode> pool;
+  std::vector<std::size_t> slabs;
+  std::size_t slots = 0;
+  for (int i = 0; i < 20000; ++i)
+  {
+    pool.allocate();
+    if (pool.getSlotCount() != slots)
+    {
+      slabs.push_back(pool.getSlotCount() - slots);
+      slots = pool.getSlotCount();
+    }
+  }
+
+  const std::size_t cap = slabs.back();
+  BOOST_CHECK_EQUAL(slabs.front(), 16);
+  for (std::size_t i = 1; i < slabs.size(); ++i)
+    BOOST_CHECK_EQUAL(slabs[i], std::min(2 * slabs[i - 1], cap));
+  BOOST_CHECK(cap * sizeof(PoolNode) <= 16 * 1024);
+  BOOST_CHECK(2 * cap * sizeof(PoolNode) > 16 * 1024);
+}
+
+BOOST_AUTO_TEST_CASE(GivenPoolsSharedOneNodeAtATime_WhenNodesAreFreed_ThenSlotsDoNotPileUp)
+{
+  // the concat and popFirst pattern of a queue fed by short lived lists
+  aisdi::NodePool<PoolNode> queue;
+  PoolNode* held = queue.allocate();
+  for (int i = 0; i < 100000; ++i)
+  {
+    aisdi::NodePool<PoolNode> list;
+    PoolNode* node = list.allocate();
+    queue.share(list);
+    queue.deallocate(held);
+    held = node;
+  }
+
+  // each list brought a slab of 16 slots, 1.6 million in all
+  BOOST_CHECK(queue.getSlotCount() < 4096);
+  queue.deallocate(held);
+}
+
+BOOST_AUTO_TEST_CASE(GivenSharedPools_WhenEitherFreesTheOthersNode_ThenSlotsAreCountedOnce)
+{
+  aisdi::NodePool<PoolNode> first;
+  aisdi::NodePool<PoolNode> second;
+  PoolNode* a = first.allocate();
+  PoolNode* b = second.allocate();
+
+  first.share(second);
+  second.deallocate(a);
+  first.deallocate(b);
+
+  BOOST_CHECK_EQUAL(first.getSlotCount(), 32);
+  BOOST_CHECK_EQUAL(second.getSlotCount(), 32);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,617 @@
+#ifndef AISDI_LINEAR_MAPPEDVECTOR_H
+#define AISDI_LINEAR_MAPPEDVECTOR_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Checking.h"
+#include "Span.h"
+
+namespace aisdi
+{
+
+// Vector of trivially copyable items kept in a memory mapped file, for item
+// tables larger than RAM or ones that should survive the process. The file
+// is a 64 byte header (magic, format version, item size, item count)
+// followed by the items exactly as they lie in memory, so opening an
+// existing file maps it and is done: there is nothing to parse or rebuild,
+// and pages are read in as they are first touched.
+//
+// append grows the file instead of calling addMemory: when it is full, the
+// file is doubled with posix_fallocate and the mapping grown with mremap,
+// which may move the items in the address space but never copies them.
+// Pointers and references into the items are invalidated by that, iterators
+// are not, as they hold an index.
+// Changes reach the file on the kernel's schedule; sync() forces them out.
+template <typename Type, class Checking = DefaultChecking>
+class MappedVector
+{
+  static_assert(std::is_trivially_copyable<Type>::value, "MappedVector holds trivially copyable items only");
+
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  // hints passed on to madvise
+  enum class Access { Normal, Sequential, Random, WillNeed };
+
+  static constexpr std::uint32_t formatVersion = 1;
+
+private:
+  struct Header
+  {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t itemSize;
+    std::uint64_t count;
+    unsigned char reserved[40];
+  };
+  static_assert(sizeof(Header) == 64, "items start at byte 64 of the file");
+  static_assert(alignof(Type) <= 64, "items have to be aligned at byte 64 of the file");
+
+  static constexpr size_type initialCapacity = 4096 / sizeof(Type) > 0 ? 4096 / sizeof(Type) : 1;
+
+  int file;
+  Header* header; //start of the mapping
+  size_type allocated; //items the file has room for
+
+  static void fail(const char* what);
+  static size_type fileBytes(size_type capacity)
+  {
+    return sizeof(Header) + capacity * sizeof(Type);
+  }
+  void resizeFile(size_type capacity);
+  void map(size_type capacity);
+  void remap(size_type capacity);
+  void unmap();
+  Type* items() const
+  {
+    return reinterpret_cast<Type*>(header + 1);
+  }
+
+public:
+  explicit MappedVector(const std::string& path); //opens the file, creating an empty vector if it is missing
+  MappedVector(const MappedVector&) = delete;
+  MappedVector& operator=(const MappedVector&) = delete;
+  MappedVector(MappedVector&& other); //other may only be destroyed afterwards
+  ~MappedVector();
+
+  value_type& operator[](size_type i);
+  const value_type& operator[](size_type i) const;
+  pointer data(); //invalidated by growing
+  const_pointer data() const;
+  Span<Type> asSpan();
+  Span<const Type> asSpan() const;
+  bool isEmpty() const;
+  size_type getSize() const;
+  size_type capacity() const;
+  void reserve(size_type newCapacity); //grows the file
+  void shrinkToFit(); //shrinks the file to the items
+  void append(const Type& item);
+  template <typename InputIterator>
+  void appendRange(InputIterator firstItem, InputIterator lastItem);
+  Type popLast();
+  void clear();
+  void sync(); //msync, returns once the items are on disk
+  void advise(Access access); //madvise over the whole mapping
+
+  iterator begin()
+  {
+    return Iterator(ConstIterator(this, 0));
+  }
+
+  iterator end()
+  {
+    return Iterator(ConstIterator(this, getSize()));
+  }
+
+  const_iterator cbegin() const
+  {
+    return ConstIterator(this, 0);
+  }
+
+  const_iterator cend() const
+  {
+    return ConstIterator(this, getSize());
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+};
+
+// Holds the owner and an index rather than a pointer, so it stays valid
+// when growing maps the file at another address.
+template <typename Type, class Checking>
+class MappedVector<Type, Checking>::ConstIterator
+{
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename MappedVector::value_type;
+  using difference_type = typename MappedVector::difference_type;
+  using pointer = typename MappedVector::const_pointer;
+  using reference = typename MappedVector::const_reference;
+
+private:
+  const MappedVector* p;
+  difference_type index;
+
+public:
+  explicit ConstIterator()
+    : p(nullptr), index(0)
+  {}
+
+  ConstIterator(const MappedVector* vec, difference_type i)
+    : p(vec), index(i)
+  {
+    if (Checking::enabled && (i > static_cast<difference_type>(vec->getSize()) || i < 0)) throw std::out_of_range("");
+  }
+
+  reference operator*() const
+  {
+    if (Checking::enabled && (index < 0 || index >= static_cast<difference_type>(p->getSize())))
+      throw std::out_of_range("there is no element with this index");
+    return p->items()[index];
+  }
+
+  pointer operator->() const
+  {
+    return &operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return *(*this + d);
+  }
+
+  difference_type getIndex() const
+  {
+    return index;
+  }
+
+  ConstIterator& operator++()
+  {
+    return *this += 1;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp(*this);
+    operator++();
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    return *this -= 1;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp(*this);
+    operator--();
+    return tmp;
+  }
+
+  ConstIterator& operator+=(difference_type d)
+  {
+    if (Checking::enabled && (index + d < 0 || index + d > static_cast<difference_type>(p->getSize())))
+      throw std::out_of_range("iterator out of range");
+    index += d;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    ConstIterator tmp(*this);
+    return tmp += d;
+  }
+
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    ConstIterator tmp(*this);
+    return tmp -= d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return index - other.index;
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return p == other.p && index == other.index;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+  bool operator<(const ConstIterator& other) const
+  {
+    return index < other.index;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
+
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
+  }
+};
+
+template <typename Type, class Checking>
+class MappedVector<Type, Checking>::Iterator : public MappedVector<Type, Checking>::ConstIterator
+{
+public:
+  using pointer = typename MappedVector::pointer;
+  using reference = typename MappedVector::reference;
+
+  explicit Iterator() {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator& operator+=(difference_type d)
+  {
+    ConstIterator::operator+=(d);
+    return *this;
+  }
+
+  Iterator& operator-=(difference_type d)
+  {
+    ConstIterator::operator-=(d);
+    return *this;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  friend Iterator operator+(difference_type d, const Iterator& it)
+  {
+    return it + d;
+  }
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return ConstIterator::operator-(other);
+  }
+
+  reference operator*() const
+  {
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+
+  pointer operator->() const
+  {
+    return &operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return *(*this + d);
+  }
+};
+
+template <typename Type, class Checking>
+void MappedVector<Type, Checking> :: fail(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Sizes the file for capacity items. Space for a grown range is allocated
+// on disk right away, so a full disk fails here instead of raising SIGBUS on
+// the first store into a hole of a sparse file.
+template <typename Type, class Checking>
+void MappedVector<Type, Checking> :: resizeFile(size_type capacity)
+{
+    const off_t bytes = static_cast<off_t>(fileBytes(capacity));
+    struct stat status;
+    if (fstat(file, &status) != 0) fail("cannot read the size of the mapped file");
+    if (bytes < status.st_size)
+    {
+        if (ftruncate(file, bytes) != 0) fail("cannot resize the mapped file");
+    }
+    else if (bytes > status.st_size)
+    {
+        const int error = posix_fallocate(file, status.st_size, bytes - status.st_size);
+        if (error != 0)
+        {
+            errno = error;
+            fail("cannot allocate space for the mapped file");
+        }
+    }
+}
+
+// Sizes the file for capacity items and maps all of it.
+template <typename Type, class Checking>
+void MappedVector<Type, Checking> :: map(size_type capacity)
+{
+    resizeFile(capacity);
+    void* mapping = mmap(nullptr, fileBytes(capacity), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (mapping == MAP_FAILED) fail("cannot map the file");
+    header = static_cast<Header*>(mapping);
+    allocated = capacity;
+}
+
+// Resizes the file and the mapping to capacity items. The old mapping stays
+// in place until mremap succeeds, so on failure the vector is unchanged; at
+// worst a grown file keeps its extra room, which reopening sees as capacity.
+template <typename Type, class Checking>
+void MappedVector<Type, Checking> :: remap(size_type capacity)
+{
+    const size_type oldCapacity = allocated;
+    if (capacity > oldCapacity) resizeFile(capacity);
+    void* mapping = mremap(header, fileBytes(oldCapacity), fileBytes(capacity), MREMAP_MAYMOVE);
+    if (mapping == MAP_FAILED) fail("cannot map the file");
+    header = static_cast<Header*>(mapping);
+    allocated = capacity;
+    if (capacity < oldCapacity) resizeFile(capacity);
+}
+
+template <typename Type, class Checking>
+void MappedVector<Type, Checking> :: unmap()
+{
+    if (header != nullptr) munmap(header, fileBytes(allocated));
+    header = nullptr;
+}
+
+template <typename Type, class Checking>
+MappedVector<Type, Checking> :: MappedVector(const std::string& path)
+    : file(-1), header(nullptr), allocated(0)
+{
+    static const char magic[8] = { 'A', 'I', 'S', 'D', 'I', 'M', 'V', '\0' };
+
+    file = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (file < 0) fail("cannot open the mapped file");
+    try
+    {
+        struct stat status;
+        if (fstat(file, &status) != 0) fail("cannot read the size of the mapped file");
+        const size_type bytes = static_cast<size_type>(status.st_size);
+        if (bytes == 0)
+        {
+            map(initialCapacity);
+            std::memcpy(header->magic, magic, sizeof(magic));
+            header->version = formatVersion;
+            header->itemSize = sizeof(Type);
+            header->count = 0;
+            return;
+        }
+        if (bytes < sizeof(Header) || (bytes - sizeof(Header)) % sizeof(Type) != 0)
+            throw std::runtime_error("mapped file has a broken size");
+        map((bytes - sizeof(Header)) / sizeof(Type));
+        if (std::memcmp(header->magic, magic, sizeof(magic)) != 0)
+            throw std::runtime_error("file does not hold a mapped vector");
+        if (header->version != formatVersion)
+            throw std::runtime_error("mapped file has an unknown format version");
+        if (header->itemSize != sizeof(Type))
+            throw std::runtime_error("mapped file holds items of another size");
+        if (header->count > allocated)
+            throw std::runtime_error("mapped file is truncated");
+    }
+    catch (...)
+    {
+        unmap();
+        close(file);
+        throw;
+    }
+}
+
+template <typename Type, class Checking>
+MappedVector<Type, Checking> :: MappedVector(MappedVector&& other)
+    : file(other.file), header(other.header), allocated(other.allocated)
+{
+    other.file = -1;
+    other.header = nullptr;
+    other.allocated = 0;
+}
+
+template <typename Type, class Checking>
+MappedVector<Type, Checking> :: ~MappedVector()
+{
+    unmap();
+    if (file >= 0) close(file);
+}
+
+template <typename Type, class Checking>
+typename MappedVector<Type, Checking>::value_type& MappedVector<Type, Checking> :: operator[](size_type i)
+{
+    return items()[i];
+}
+
+template <typename Type, class Checking>
+const typename MappedVector<Type, Checking>::value_type& MappedVector<Type, Checking> :: operator[](size_type i) const
+{
+    return items()[i];
+}
+
+template <typename Type, class Checking>
+typename MappedVector<Type, Checking>::pointer MappedVector<Type, Checking> :: data()
+{
+    return items();
+}
+
+template <typename Type, class Checking>
+typename MappedVector<Type, Checking>::const_pointer MappedVector<Type, Checking> :: data() const
+{
+    return items();
+}
+
+template <typename Type, class Checking>
+Span<Type> MappedVector<Type, Checking> :: asSpan()
+{
+    return Span<Type>(items(), getSize());
+}
+
+template <typename Type, class Checking>
+Span<const Type> MappedVector<Type, Checking> :: asSpan() const
+{
+    return Span<const Type>(items(), getSize());
+}
+
+template <typename Type, class Checking>
+bool MappedVector<Type, Checking> :: isEmpty() const
+{
+    return getSize() == 0;
+}
+
+template <typename Type, class Checking>
+typename MappedVector<Type, Checking>::size_type MappedVector<Type, Checking> :: getSize() const
+{
+    return static_cast<size_type>(header->count);
+}
+
+template <typename Type, class Checking>
+typename MappedVector<Type, Checking>::size_type MappedVector<Type, Checking> :: capacity() const
+{
+    return allocated;
+}
+
+template <typename Type, class Checking>
+void MappedVector<Type, Checking> :: reserve(size_type newCapacity)
+{
+    if (newCapacity <= allocated) return;
+    remap(newCapacity);
+}
+
+template <typename Type, class Checking>
+void MappedVector<Type, Checking> :: shrinkToFit()
+{
+    const size_type count = getSize() > 0 ? getSize() : 1;
+    if (count == allocated) return;
+    remap(count);
+}
+
+template <typename Type, class Checking>
+void MappedVector<Type, Checking> :: append(const Type& item)
+{
+    if (getSize() == allocated)
+    {
+        Type copy = item; //item may live in the mapping that is about to move
+        reserve(allocated > 0 ? 2 * allocated : initialCapacity); //a file may hold just the header
+        items()[header->count++] = copy;
+        return;
+    }
+    items()[header->count++] = item;
+}
+
+template <typename Type, class Checking>
+template <typename InputIterator>
+void MappedVector<Type, Checking> :: appendRange(InputIterator firstItem, InputIterator lastItem)
+{
+    for (; firstItem != lastItem; ++firstItem)
+        append(*firstItem);
+}
+
+template <typename Type, class Checking>
+Type MappedVector<Type, Checking> :: popLast()
+{
+    if (getSize() == 0) throw std::logic_error("vector is empty");
+    return items()[--header->count];
+}
+
+template <typename Type, class Checking>
+void MappedVector<Type, Checking> :: clear()
+{
+    header->count = 0;
+}
+
+template <typename Type, class Checking>
+void MappedVector<Type, Checking> :: sync()
+{
+    if (msync(header, fileBytes(allocated), MS_SYNC) != 0) fail("cannot sync the mapped file");
+}
+
+template <typename Type, class Checking>
+void MappedVector<Type, Checking> :: advise(Access access)
+{
+    int advice = MADV_NORMAL;
+    if (access == Access::Sequential) advice = MADV_SEQUENTIAL;
+    else if (access == Access::Random) advice = MADV_RANDOM;
+    else if (access == Access::WillNeed) advice = MADV_WILLNEED;
+    if (madvise(header, fileBytes(allocated), advice) != 0) fail("cannot advise on the mapping");
+}
+
+}
+#endif // AISDI_LINEAR_MAPPEDVECTOR_H
@@ -0,0 +1,115 @@
+#ifndef AISDI_LINEAR_MEMORY_H
+#define AISDI_LINEAR_MEMORY_H
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace aisdi
+{
+
+// Bytes in a CPU cache line. Data written by different threads should not
+// share one, or every write invalidates the line for the other thread.
+constexpr std::size_t cacheLineSize = 64;
+
+// Tells whether moving an object to a new address and forgetting the old one
+// may be done with a plain memmove. Every trivially copyable type qualifies;
+// specialize it for other types that hold no pointers into themselves.
+template <typename Type>
+struct is_trivially_relocatable : std::is_trivially_copyable<Type>
+{};
+
+// Raw, uninitialized storage for count objects.
+template <typename Type>
+Type* allocateStorage(std::size_t count)
+{
+    if (count == 0) return nullptr;
+    if (count > std::numeric_limits<std::size_t>::max() / sizeof(Type)) throw std::bad_array_new_length();
+    return static_cast<Type*>(::operator new(count * sizeof(Type)));
+}
+
+template <typename Type>
+void deallocateStorage(Type* storage)
+{
+    ::operator delete(storage);
+}
+
+// Uninitialized room for N objects inside whatever derives from it. The N == 0
+// specialization is empty, so as a base class it takes no space at all.
+template <typename Type, std::size_t N>
+class InlineStorage
+{
+private:
+  alignas(Type) unsigned char bytes[N * sizeof(Type)];
+
+public:
+  Type* inlineItems() const
+  {
+    return reinterpret_cast<Type*>(const_cast<unsigned char*>(bytes));
+  }
+};
+
+template <typename Type>
+class InlineStorage<Type, 0>
+{
+public:
+  Type* inlineItems() const
+  {
+    return nullptr;
+  }
+};
+
+template <typename Type>
+void destroyRange(Type* items, std::size_t count)
+{
+    if (std::is_trivially_destructible<Type>::value) return;
+    for (std::size_t i = 0; i < count; i++)
+        items[i].~Type();
+}
+
+template <typename Type>
+void relocateForward(Type* to, Type* from, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        new (&to[i]) Type(std::move(from[i]));
+        from[i].~Type();
+    }
+}
+
+template <typename Type>
+void relocateBackward(Type* to, Type* from, std::size_t count)
+{
+    for (std::size_t i = count; i > 0; i--)
+    {
+        new (&to[i - 1]) Type(std::move(from[i - 1]));
+        from[i - 1].~Type();
+    }
+}
+
+// Moves count objects from `from` to the uninitialized storage at `to`,
+// leaving `from` uninitialized. The two ranges may overlap.
+//
+// Each object is destroyed right after it is moved, which is what lets the
+// ranges overlap, so a move that throws half way would leave some objects
+// moved and the rest not, with no way back. Moves must therefore not throw
+// (or the type must be trivially relocatable, which needs no move at all).
+template <typename Type>
+void relocate(Type* to, Type* from, std::size_t count)
+{
+    static_assert(is_trivially_relocatable<Type>::value || std::is_nothrow_move_constructible<Type>::value,
+                  "items are relocated with moves that must not throw");
+    if (count == 0 || to == from) return;
+    if (is_trivially_relocatable<Type>::value)
+        std::memmove(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(Type));
+    else if (to < from)
+        relocateForward(to, from, count);
+    else
+        relocateBackward(to, from, count);
+}
+
+}
+#endif // AISDI_LINEAR_MEMORY_H
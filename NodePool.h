@@ -0,0 +1,391 @@
+#ifndef AISDI_LINEAR_NODEPOOL_H
+#define AISDI_LINEAR_NODEPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace aisdi
+{
+
+// Node allocators used by LinkedList. Both hand out raw memory for a single
+// Node; constructing and destroying the node itself is up to the caller.
+// After a.share(b), nodes allocated by either of them may be deallocated by
+// the other, which is what lets LinkedList splice nodes between lists.
+
+template <typename Node>
+class HeapNodeAllocator
+{
+public:
+  HeapNodeAllocator() {}
+  HeapNodeAllocator(const HeapNodeAllocator&) = delete;
+  HeapNodeAllocator& operator=(const HeapNodeAllocator&) = delete;
+
+  Node* allocate()
+  {
+    return static_cast<Node*>(::operator new(sizeof(Node)));
+  }
+
+  void deallocate(Node* node)
+  {
+    ::operator delete(node);
+  }
+
+  void swap(HeapNodeAllocator&) {}
+
+  void share(HeapNodeAllocator&) {}
+};
+
+// Carves nodes out of slabs and recycles freed nodes through an intrusive
+// free list. The first slab holds 16 nodes and each next one twice as many,
+// up to about 16 KiB, so short lists stay small. Once the free list holds
+// more slots than the pool has handed out (and at least a slab's worth),
+// deallocate() sweeps it and returns the slabs with no live node to the
+// system; the limit doubles when a sweep frees little, so sweeping costs
+// O(log slabs) per deallocation, amortized. The rest of the slabs go when
+// the last pool using them is destroyed.
+//
+// A pool is a handle to a reference counted State. share() folds the state
+// of one pool into the other's, leaving the old state to forward there, so
+// any number of pools (and the nodes they have handed out) end up backed by
+// one set of slabs.
+//
+// Lists that spliced nodes between them may later be used on different
+// threads, so a state shared by several pools is synchronized: every
+// allocate and deallocate takes its mutex. Once the other pools are gone,
+// the one left with the state drops back to lock free.
+template <typename Node>
+class NodePool
+{
+private:
+  union Slot
+  {
+    Slot* nextFree;
+    alignas(Node) unsigned char storage[sizeof(Node)];
+  };
+
+  // kept in the first headerSlots slots of every slab
+  struct Slab
+  {
+    Slab* older;
+    std::size_t slots;
+    std::size_t freeSlots; // counted by sweep() only
+  };
+
+  static constexpr std::size_t SLAB_BYTES = 16 * 1024;
+  static constexpr std::size_t headerSlots = (sizeof(Slab) + sizeof(Slot) - 1) / sizeof(Slot);
+  static constexpr std::size_t minSlotsPerSlab = 16;
+  static constexpr std::size_t maxSlotsPerSlab =
+    SLAB_BYTES / sizeof(Slot) > headerSlots + minSlotsPerSlab ? SLAB_BYTES / sizeof(Slot) - headerSlots : minSlotsPerSlab;
+
+  struct State
+  {
+    std::atomic<std::size_t> references; // pools using this state, plus states forwarding to it
+    std::atomic<State*> forward;         // set once folded into another state
+    bool synchronized; // set while shared; then the fields below are used under mutex
+    std::mutex mutex;
+    Slab* newestSlab;
+    Slab* oldestSlab;
+    Slot* freeList;  // slots returned by deallocate()
+    Slot* freeTail;
+    Slot* cursor;    // next never-used slot in the newest slab
+    Slot* slabEnd;
+    std::size_t slabSlots; // size of the next slab
+    std::size_t slotCount; // slots in all slabs, handed out or not
+    std::size_t live;      // slots handed out and not deallocated yet
+    std::size_t freeCount; // length of freeList
+    std::size_t sweepAt;   // freeCount that triggers the next sweep
+
+    State()
+      : references(1), forward(nullptr), synchronized(false),
+        newestSlab(nullptr), oldestSlab(nullptr), freeList(nullptr), freeTail(nullptr),
+        cursor(nullptr), slabEnd(nullptr), slabSlots(minSlotsPerSlab),
+        slotCount(0), live(0), freeCount(0), sweepAt(maxSlotsPerSlab)
+    {}
+  };
+
+  State* state; // nullptr until first needed
+
+  State* current();
+  State* lockCurrent(std::unique_lock<std::mutex>& lock);
+  static void release(State* s);
+  static Slot* slotsOf(Slab* slab)
+  {
+    return reinterpret_cast<Slot*>(slab) + headerSlots;
+  }
+  static void pushFree(State* s, Slot* slot);
+  static void addSlab(State* s);
+  static void sweep(State* s);
+
+public:
+  NodePool();
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+  ~NodePool();
+
+  Node* allocate();
+  void deallocate(Node* node);
+  void swap(NodePool& other);
+  void share(NodePool& other);
+
+  std::size_t getSlotCount(); // slots in the slabs backing this pool, handed out or free
+};
+
+template <typename Node>
+NodePool<Node>::NodePool()
+{
+    state = nullptr;
+}
+
+template <typename Node>
+NodePool<Node>::~NodePool()
+{
+    release(state);
+}
+
+// the state this pool allocates from, following (and shortening) forwards
+template <typename Node>
+typename NodePool<Node>::State* NodePool<Node>::current()
+{
+    if (state == nullptr)
+    {
+        state = new State();
+        return state;
+    }
+    while (State* next = state->forward.load(std::memory_order_acquire))
+    {
+        next->references.fetch_add(1, std::memory_order_relaxed);
+        release(state);
+        state = next;
+    }
+    return state;
+}
+
+// Another thread may fold the state we found into a third one before we get
+// its lock, so the lock only counts once the state is still the current one.
+// A state referenced by this pool alone cannot be reached from elsewhere, and
+// the acquire pairs with the release of the last other reference to it.
+template <typename Node>
+typename NodePool<Node>::State* NodePool<Node>::lockCurrent(std::unique_lock<std::mutex>& lock)
+{
+    for (;;)
+    {
+        State* s = current();
+        if (s->synchronized && s->references.load(std::memory_order_acquire) == 1) s->synchronized = false;
+        if (!s->synchronized) return s;
+        lock = std::unique_lock<std::mutex>(s->mutex);
+        if (s->forward.load(std::memory_order_relaxed) == nullptr) return s;
+        lock.unlock();
+    }
+}
+
+template <typename Node>
+void NodePool<Node>::release(State* s)
+{
+    while (s != nullptr && s->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        State* next = s->forward.load(std::memory_order_relaxed);
+        while (s->newestSlab != nullptr)
+        {
+            Slab* older = s->newestSlab->older;
+            ::operator delete(s->newestSlab);
+            s->newestSlab = older;
+        }
+        delete s;
+        s = next;
+    }
+}
+
+template <typename Node>
+void NodePool<Node>::pushFree(State* s, Slot* slot)
+{
+    slot->nextFree = s->freeList;
+    if (s->freeList == nullptr) s->freeTail = slot;
+    s->freeList = slot;
+    s->freeCount++;
+}
+
+template <typename Node>
+void NodePool<Node>::addSlab(State* s)
+{
+    void* memory = ::operator new(sizeof(Slot) * (headerSlots + s->slabSlots));
+    Slab* slab = new (memory) Slab{s->newestSlab, s->slabSlots, 0};
+    if (s->newestSlab == nullptr) s->oldestSlab = slab;
+    s->newestSlab = slab;
+    s->cursor = slotsOf(slab);
+    s->slabEnd = s->cursor + slab->slots;
+    s->slotCount += slab->slots;
+    if (s->slabSlots < maxSlotsPerSlab)
+        s->slabSlots = 2 * s->slabSlots < maxSlotsPerSlab ? 2 * s->slabSlots : maxSlotsPerSlab;
+}
+
+// Counts the free slots of every slab, finding each slot's slab by binary
+// search, then drops the slabs whose slots are all free from the slab chain
+// and their slots from the free list. The slab still being carved never
+// qualifies, as its uncarved slots are not on the free list.
+template <typename Node>
+void NodePool<Node>::sweep(State* s)
+{
+    std::vector<Slab*> slabs;
+    try
+    {
+        for (Slab* slab = s->newestSlab; slab != nullptr; slab = slab->older) slabs.push_back(slab);
+    }
+    catch (const std::bad_alloc&)
+    {
+        s->sweepAt = 2 * s->freeCount;
+        return;
+    }
+    std::sort(slabs.begin(), slabs.end(), std::less<Slab*>());
+    auto slabOf = [&slabs](Slot* slot) {
+        return *(std::upper_bound(slabs.begin(), slabs.end(), reinterpret_cast<Slab*>(slot), std::less<Slab*>()) - 1);
+    };
+    for (Slot* slot = s->freeList; slot != nullptr; slot = slot->nextFree) slabOf(slot)->freeSlots++;
+
+    Slot** link = &s->freeList;
+    s->freeTail = nullptr;
+    for (Slot* slot = s->freeList; slot != nullptr; slot = slot->nextFree)
+    {
+        const Slab* slab = slabOf(slot);
+        if (slab->freeSlots == slab->slots) s->freeCount--;
+        else
+        {
+            *link = slot;
+            link = &slot->nextFree;
+            s->freeTail = slot;
+        }
+    }
+    *link = nullptr;
+
+    Slab** older = &s->newestSlab;
+    s->oldestSlab = nullptr;
+    while (Slab* slab = *older)
+        if (slab->freeSlots == slab->slots)
+        {
+            if (s->slabEnd == slotsOf(slab) + slab->slots) s->cursor = s->slabEnd = nullptr;
+            *older = slab->older;
+            s->slotCount -= slab->slots;
+            ::operator delete(slab);
+        }
+        else
+        {
+            slab->freeSlots = 0;
+            s->oldestSlab = slab;
+            older = &slab->older;
+        }
+    s->sweepAt = std::max(2 * s->freeCount, s->live) + maxSlotsPerSlab;
+}
+
+template <typename Node>
+Node* NodePool<Node>::allocate()
+{
+    std::unique_lock<std::mutex> lock;
+    State* s = lockCurrent(lock);
+    Slot* slot;
+    if (s->freeList != nullptr)
+    {
+        slot = s->freeList;
+        s->freeList = slot->nextFree;
+        s->freeCount--;
+    }
+    else
+    {
+        if (s->cursor == s->slabEnd) addSlab(s);
+        slot = s->cursor++;
+    }
+    s->live++;
+    return reinterpret_cast<Node*>(slot->storage);
+}
+
+template <typename Node>
+void NodePool<Node>::deallocate(Node* node)
+{
+    std::unique_lock<std::mutex> lock;
+    State* s = lockCurrent(lock);
+    pushFree(s, reinterpret_cast<Slot*>(node));
+    s->live--;
+    if (s->freeCount > s->sweepAt && s->freeCount > s->live) sweep(s);
+}
+
+template <typename Node>
+void NodePool<Node>::swap(NodePool& other)
+{
+    std::swap(state, other.state);
+}
+
+// O(1), apart from putting the unused rest of one slab on the free list.
+// Both states are locked, as other pools may be using them on other
+// threads; if either got folded elsewhere meanwhile, the states are looked
+// up again.
+template <typename Node>
+void NodePool<Node>::share(NodePool& other)
+{
+    State* mine;
+    State* theirs;
+    for (;;)
+    {
+        mine = current();
+        theirs = other.current();
+        if (mine == theirs) return;
+        std::unique_lock<std::mutex> lockMine(mine->mutex, std::defer_lock);
+        std::unique_lock<std::mutex> lockTheirs(theirs->mutex, std::defer_lock);
+        std::lock(lockMine, lockTheirs);
+        if (mine->forward.load(std::memory_order_relaxed) != nullptr ||
+            theirs->forward.load(std::memory_order_relaxed) != nullptr) continue;
+
+        if (theirs->newestSlab != nullptr)
+        {
+            theirs->oldestSlab->older = mine->newestSlab;
+            if (mine->newestSlab == nullptr) mine->oldestSlab = theirs->oldestSlab;
+            mine->newestSlab = theirs->newestSlab;
+        }
+        if (theirs->freeList != nullptr)
+        {
+            theirs->freeTail->nextFree = mine->freeList;
+            if (mine->freeList == nullptr) mine->freeTail = theirs->freeTail;
+            mine->freeList = theirs->freeList;
+        }
+        mine->freeCount += theirs->freeCount;
+        mine->live += theirs->live;
+        mine->slotCount += theirs->slotCount;
+        // only one partly carved slab can be continued, the one with more
+        // left; the rest of the other goes on the free list
+        if (theirs->slabEnd - theirs->cursor > mine->slabEnd - mine->cursor)
+        {
+            std::swap(mine->cursor, theirs->cursor);
+            std::swap(mine->slabEnd, theirs->slabEnd);
+        }
+        while (theirs->cursor != theirs->slabEnd) pushFree(mine, theirs->cursor++);
+        mine->slabSlots = std::max(mine->slabSlots, theirs->slabSlots);
+        mine->sweepAt = std::max(mine->sweepAt, theirs->sweepAt);
+        theirs->newestSlab = nullptr;
+        theirs->oldestSlab = nullptr;
+        theirs->freeList = nullptr;
+        theirs->freeTail = nullptr;
+        theirs->cursor = nullptr;
+        theirs->slabEnd = nullptr;
+        // still false means no other pool has mine, so no other thread reads it
+        if (!mine->synchronized) mine->synchronized = true;
+
+        mine->references.fetch_add(2, std::memory_order_relaxed); // theirs forwards here, and so does other
+        theirs->forward.store(mine, std::memory_order_release);
+        break;
+    }
+    other.state = mine;
+    release(theirs);
+}
+
+template <typename Node>
+std::size_t NodePool<Node>::getSlotCount()
+{
+    std::unique_lock<std::mutex> lock;
+    return lockCurrent(lock)->slotCount;
+}
+
+}
+#endif // AISDI_LINEAR_NODEPOOL_H
@@ -0,0 +1,174 @@
+#ifndef AISDI_LINEAR_PARALLELALGORITHMS_H
+#define AISDI_LINEAR_PARALLELALGORITHMS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Memory.h"
+#include "Span.h"
+#include "ThreadPool.h"
+#include "Vector.h"
+
+namespace aisdi
+{
+
+// Splits n items starting at `items` into chunks for the threads of a pool.
+// Every chunk boundary except the ends falls on a cache line boundary (when
+// sizeof(Type) divides the line), so no cache line is written by two threads.
+// There are a few chunks per thread for load balancing, but none smaller
+// than minimumChunk items.
+template <typename Type>
+class CacheLineChunks
+{
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type minimumChunk = 4096;
+  static constexpr size_type chunksPerThread = 4;
+
+private:
+  size_type n;
+  size_type head; //items before the first cache line boundary
+  size_type size; //items per chunk after the first, a whole number of lines
+  size_type count;
+
+public:
+  CacheLineChunks(const Type* items, size_type itemCount, size_type threads)
+    : n(itemCount), head(0)
+  {
+    const size_type perLine = sizeof(Type) < cacheLineSize ? cacheLineSize / sizeof(Type) : 1;
+    if (cacheLineSize % sizeof(Type) == 0)
+    {
+        const size_type misalignment = reinterpret_cast<std::uintptr_t>(items) % cacheLineSize;
+        if (misalignment % sizeof(Type) == 0)
+            head = (cacheLineSize - misalignment) % cacheLineSize / sizeof(Type);
+    }
+    size = n / (threads * chunksPerThread + 1);
+    if (size < minimumChunk) size = minimumChunk;
+    size = (size + perLine - 1) / perLine * perLine;
+    if (head >= n) count = n == 0 ? 0 : 1;
+    else count = 1 + (n - head - 1) / size;
+  }
+
+  size_type getCount() const
+  {
+    return count;
+  }
+
+  size_type begin(size_type chunk) const
+  {
+    return chunk == 0 ? 0 : head + chunk * size;
+  }
+
+  size_type end(size_type chunk) const
+  {
+    const size_type last = head + (chunk + 1) * size;
+    return last < n ? last : n;
+  }
+};
+
+// Parallel algorithms over contiguous items. They run on `pool` (the shared,
+// hardware sized one by default); with one thread or few items they simply
+// run on the caller. Functions must be safe to call concurrently.
+
+template <typename Type, typename Function>
+void parallelForEach(Span<Type> items, Function function, ThreadPool& pool = ThreadPool::shared())
+{
+    const CacheLineChunks<Type> chunks(items.data(), items.getSize(), pool.getThreadCount());
+    pool.forEachIndex(chunks.getCount(), [&](std::size_t chunk) {
+        for (std::size_t i = chunks.begin(chunk); i < chunks.end(chunk); i++)
+            function(items[i]);
+    });
+}
+
+// target[i] = function(source[i]); both must have the same size. Chunks are
+// aligned to the target, the side being written.
+template <typename Source, typename Target, typename Function>
+void parallelTransform(Span<const Source> source, Span<Target> target, Function function,
+                       ThreadPool& pool = ThreadPool::shared())
+{
+    if (source.getSize() != target.getSize())
+        throw std::invalid_argument("transform source and target differ in size");
+    const CacheLineChunks<Target> chunks(target.data(), target.getSize(), pool.getThreadCount());
+    pool.forEachIndex(chunks.getCount(), [&](std::size_t chunk) {
+        for (std::size_t i = chunks.begin(chunk); i < chunks.end(chunk); i++)
+            target[i] = function(source[i]);
+    });
+}
+
+template <typename Type>
+void parallelFill(Span<Type> items, const Type& value, ThreadPool& pool = ThreadPool::shared())
+{
+    const CacheLineChunks<Type> chunks(items.data(), items.getSize(), pool.getThreadCount());
+    pool.forEachIndex(chunks.getCount(), [&](std::size_t chunk) {
+        for (std::size_t i = chunks.begin(chunk); i < chunks.end(chunk); i++)
+            items[i] = value;
+    });
+}
+
+// Folds items into initial with combine(Result, Result), which has to be
+// associative; items must convert to Result. Every chunk is folded on its
+// own, starting from its first item, then the partial results are folded in
+// chunk order, so non-commutative operations give the serial result too.
+// Each partial result sits in its own cache line.
+template <typename Type, typename Result, typename Combine>
+Result parallelReduce(Span<const Type> items, Result initial, Combine combine, ThreadPool& pool = ThreadPool::shared())
+{
+    struct alignas(cacheLineSize) Partial
+    {
+      Result value;
+    };
+
+    const CacheLineChunks<Type> chunks(items.data(), items.getSize(), pool.getThreadCount());
+    std::vector<Partial> partials(chunks.getCount(), Partial{ initial });
+    pool.forEachIndex(chunks.getCount(), [&](std::size_t chunk) {
+        std::size_t i = chunks.begin(chunk);
+        Result value = items[i++];
+        for (; i < chunks.end(chunk); i++)
+            value = combine(std::move(value), items[i]);
+        partials[chunk].value = std::move(value);
+    });
+    for (auto& partial : partials)
+        initial = combine(std::move(initial), std::move(partial.value));
+    return initial;
+}
+
+// Vector front ends
+
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth, typename Function>
+void parallelForEach(Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items, Function function,
+                     ThreadPool& pool = ThreadPool::shared())
+{
+    parallelForEach(items.asSpan(), std::move(function), pool);
+}
+
+template <typename Source, class SourceInstrumentation, class SourceChecking, std::size_t SourceInline, class SourceGrowth,
+          typename Target, class TargetInstrumentation, class TargetChecking, std::size_t TargetInline, class TargetGrowth,
+          typename Function>
+void parallelTransform(const Vector<Source, SourceInstrumentation, SourceChecking, SourceInline, SourceGrowth>& source,
+                       Vector<Target, TargetInstrumentation, TargetChecking, TargetInline, TargetGrowth>& target,
+                       Function function, ThreadPool& pool = ThreadPool::shared())
+{
+    parallelTransform(source.asSpan(), target.asSpan(), std::move(function), pool);
+}
+
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void parallelFill(Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items,
+                  const typename Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>::value_type& value,
+                  ThreadPool& pool = ThreadPool::shared())
+{
+    parallelFill(items.asSpan(), value, pool);
+}
+
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth, typename Result,
+          typename Combine>
+Result parallelReduce(const Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items, Result initial,
+                      Combine combine, ThreadPool& pool = ThreadPool::shared())
+{
+    return parallelReduce(items.asSpan(), std::move(initial), std::move(combine), pool);
+}
+
+}
+#endif // AISDI_LINEAR_PARALLELALGORITHMS_H
@@ -0,0 +1,318 @@
+#ifndef AISDI_LINEAR_PERSISTENTLIST_H
+#define AISDI_LINEAR_PERSISTENTLIST_H
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include "LinkedList.h"
+
+namespace aisdi
+{
+
+// Immutable singly linked list whose versions share structure: prepend
+// returns a new version made of one new node in front of this version's
+// nodes, and rest returns the version without the first item, both in O(1)
+// and without touching this version. Copies share all their nodes, so they
+// are free as well.
+//
+// Every node counts the versions and nodes pointing to it; the count is
+// atomic, so versions may be handed to other threads and dropped there.
+// Releasing a version frees the nodes only it used, iteratively, so even
+// very long lists do not recurse.
+template <typename Type>
+class PersistentList
+{
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using pointer = const Type*;
+  using reference = const Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  using iterator = ConstIterator;
+  using const_iterator = ConstIterator;
+
+private:
+  class Item
+  {
+    public:
+      std::atomic<size_type> references;
+      const value_type item;
+      Item* next;
+
+      template <typename... Args>
+      explicit Item(Item* tail, Args&&... args)
+        : references(1), item(std::forward<Args>(args)...), next(tail)
+      {}
+  };
+
+  Item* first;
+  size_type n;
+
+  PersistentList(Item* head, size_type count)
+    : first(head), n(count)
+  {}
+
+  static Item* acquire(Item* node);
+  static void release(Item* node);
+
+public:
+  PersistentList();
+  PersistentList(std::initializer_list<Type> l);
+  template <typename InputIterator>
+  PersistentList(InputIterator firstItem, InputIterator lastItem);
+  template <template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+  explicit PersistentList(const LinkedList<Type, NodeAllocator, Instrumentation, Checking, Indexing>& list);
+  PersistentList(const PersistentList& other); //O(1), shares every node
+  PersistentList(PersistentList&& other);
+  ~PersistentList();
+
+  PersistentList& operator=(PersistentList other);
+  void swapLists(PersistentList& x, PersistentList& y);
+
+  bool isEmpty() const;
+  size_type getSize() const;
+  const_reference front() const;
+
+  PersistentList prepend(const Type& item) const;
+  PersistentList prepend(Type&& item) const;
+  template <typename... Args>
+  PersistentList emplacePrepend(Args&&... args) const;
+  PersistentList rest() const; //this version without its first item
+
+  // whether both versions are the very same nodes
+  bool isSameAs(const PersistentList& other) const
+  {
+    return first == other.first;
+  }
+
+  template <typename List = LinkedList<Type>>
+  List toLinkedList() const
+  {
+    List list;
+    list.appendRange(cbegin(), cend());
+    return list;
+  }
+
+  const_iterator cbegin() const
+  {
+    return ConstIterator(first);
+  }
+
+  const_iterator cend() const
+  {
+    return ConstIterator(nullptr);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+};
+
+template <typename Type>
+class PersistentList<Type>::ConstIterator
+{
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename PersistentList::value_type;
+  using difference_type = typename PersistentList::difference_type;
+  using pointer = typename PersistentList::const_pointer;
+  using reference = typename PersistentList::const_reference;
+
+private:
+  const Item* node; //nullptr at the end
+
+public:
+  explicit ConstIterator(const Item* start = nullptr)
+    : node(start)
+  {}
+
+  reference operator*() const
+  {
+    if (node == nullptr) throw std::out_of_range("there is no element at the end");
+    return node->item;
+  }
+
+  pointer operator->() const
+  {
+    return &operator*();
+  }
+
+  ConstIterator& operator++()
+  {
+    if (node == nullptr) throw std::out_of_range("you cannot increase iterator");
+    node = node->next;
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp(*this);
+    operator++();
+    return tmp;
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return node == other.node;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+template <typename Type>
+typename PersistentList<Type>::Item* PersistentList<Type> :: acquire(Item* node)
+{
+    if (node != nullptr) node->references.fetch_add(1, std::memory_order_relaxed);
+    return node;
+}
+
+// A node whose count drops to zero was held only by whoever let go of it, so
+// it is freed and its reference to the next node is released in turn.
+template <typename Type>
+void PersistentList<Type> :: release(Item* node)
+{
+    while (node != nullptr && node->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        Item* next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+template <typename Type>
+PersistentList<Type> :: PersistentList()
+    : first(nullptr), n(0)
+{}
+
+template <typename Type>
+PersistentList<Type> :: PersistentList(std::initializer_list<Type> l)
+    : PersistentList(l.begin(), l.end())
+{}
+
+// Nodes are linked at the back while nobody else can see them yet.
+template <typename Type>
+template <typename InputIterator>
+PersistentList<Type> :: PersistentList(InputIterator firstItem, InputIterator lastItem)
+    : first(nullptr), n(0)
+{
+    Item** tail = &first;
+    try
+    {
+        for (; firstItem != lastItem; ++firstItem)
+        {
+            *tail = new Item(nullptr, *firstItem);
+            tail = &(*tail)->next;
+            n++;
+        }
+    }
+    catch (...)
+    {
+        release(first);
+        throw;
+    }
+}
+
+template <typename Type>
+template <template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+PersistentList<Type> :: PersistentList(const LinkedList<Type, NodeAllocator, Instrumentation, Checking, Indexing>& list)
+    : PersistentList(list.cbegin(), list.cend())
+{}
+
+template <typename Type>
+PersistentList<Type> :: PersistentList(const PersistentList& other)
+    : first(acquire(other.first)), n(other.n)
+{}
+
+template <typename Type>
+PersistentList<Type> :: PersistentList(PersistentList&& other)
+    : first(other.first), n(other.n)
+{
+    other.first = nullptr;
+    other.n = 0;
+}
+
+template <typename Type>
+PersistentList<Type> :: ~PersistentList()
+{
+    release(first);
+}
+
+template <typename Type>
+PersistentList<Type>& PersistentList<Type> :: operator=(PersistentList other)
+{
+    swapLists(*this, other);
+    return *this;
+}
+
+template <typename Type>
+void PersistentList<Type> :: swapLists(PersistentList& x, PersistentList& y)
+{
+    std::swap(x.first, y.first);
+    std::swap(x.n, y.n);
+}
+
+template <typename Type>
+bool PersistentList<Type> :: isEmpty() const
+{
+    return n == 0;
+}
+
+template <typename Type>
+typename PersistentList<Type>::size_type PersistentList<Type> :: getSize() const
+{
+    return n;
+}
+
+template <typename Type>
+typename PersistentList<Type>::const_reference PersistentList<Type> :: front() const
+{
+    if (first == nullptr) throw std::logic_error("list is empty");
+    return first->item;
+}
+
+template <typename Type>
+template <typename... Args>
+PersistentList<Type> PersistentList<Type> :: emplacePrepend(Args&&... args) const
+{
+    Item* head = new Item(first, std::forward<Args>(args)...);
+    acquire(first);
+    return PersistentList(head, n + 1);
+}
+
+template <typename Type>
+PersistentList<Type> PersistentList<Type> :: prepend(const Type& item) const
+{
+    return emplacePrepend(item);
+}
+
+template <typename Type>
+PersistentList<Type> PersistentList<Type> :: prepend(Type&& item) const
+{
+    return emplacePrepend(std::move(item));
+}
+
+template <typename Type>
+PersistentList<Type> PersistentList<Type> :: rest() const
+{
+    if (first == nullptr) throw std::logic_error("list is empty");
+    return PersistentList(acquire(first->next), n - 1);
+}
+
+}
+#endif // AISDI_LINEAR_PERSISTENTLIST_H
@@ -0,0 +1,472 @@
+#ifndef AISDI_LINEAR_RINGVECTOR_H
+#define AISDI_LINEAR_RINGVECTOR_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <new>
+#include <utility>
+#include "Memory.h"
+
+namespace aisdi
+{
+
+// Vector kept in a circular buffer: element i lives in slot (head + i) mod
+// capacity, so both ends grow and shrink in amortized O(1). Capacity is
+// always a power of two to make the wrap a mask.
+template <typename Type>
+class RingVector
+{
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+private:
+  pointer buffer;
+  size_type allocated; // zero or a power of two
+  size_type head; // slot of the first element
+  size_type n;
+
+  pointer slot(size_type i) const
+  {
+    return buffer + ((head + i) & (allocated - 1));
+  }
+
+  void reallocate(size_type newCapacity);
+  void addMemory();
+
+public:
+  RingVector();
+  RingVector(std::initializer_list<Type> l);
+  RingVector(const RingVector& other);
+  RingVector(RingVector&& other);
+  ~RingVector();
+
+  RingVector& operator=(RingVector other);
+  value_type& operator[](size_type i);
+  const value_type& operator[](size_type i) const;
+  bool isEmpty() const;
+  size_type getSize() const;
+  size_type capacity() const;
+  void reserve(size_type newCapacity);
+  void swapVectors(RingVector& x, RingVector& y);
+  void append(const Type& item);
+  void prepend(const Type& item);
+  Type popFirst();
+  Type popLast();
+  void insert(const const_iterator& insertPosition, const Type& item);
+  void erase(const const_iterator& position);
+  void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded);
+
+  iterator begin()
+  {
+    return Iterator(ConstIterator(this, 0));
+  }
+
+  iterator end()
+  {
+    return Iterator(ConstIterator(this, n));
+  }
+
+  const_iterator cbegin() const
+  {
+    return ConstIterator(this, 0);
+  }
+
+  const_iterator cend() const
+  {
+    return ConstIterator(this, n);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+};
+
+template <typename Type>
+class RingVector<Type>::ConstIterator
+{
+public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename RingVector::value_type;
+  using difference_type = typename RingVector::difference_type;
+  using pointer = typename RingVector::const_pointer;
+  using reference = typename RingVector::const_reference;
+
+private:
+  const RingVector* p;
+  size_type index; // logical position, wrapped only on dereference
+
+public:
+  explicit ConstIterator() {}
+
+  ConstIterator(const RingVector* vec, size_type i)
+  {
+    if (i > vec->n) throw std::out_of_range("");
+    p = vec;
+    index = i;
+  }
+
+  reference operator*() const
+  {
+    if (index >= p->n) throw std::out_of_range("there is no element with this index");
+    return *p->slot(index);
+  }
+
+  size_type getIndex() const
+  {
+    return index;
+  }
+
+  ConstIterator& operator++()
+  {
+    if (index >= p->n) throw std::out_of_range("you cannot increase iterator");
+    index++;
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp(*this);
+    operator++();
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    if (index == 0) throw std::out_of_range("iterator cannot be smaller than 0");
+    index--;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp(*this);
+    operator--();
+    return tmp;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    if (d > static_cast<difference_type>(p->n - index)) throw std::out_of_range("you cannot incerease iterator");
+    return ConstIterator(p, index + d);
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    if (d > static_cast<difference_type>(index)) throw std::out_of_range("iterator cannot be smaller than 0");
+    return ConstIterator(p, index - d);
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return p == other.p && index == other.index;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+template <typename Type>
+class RingVector<Type>::Iterator : public RingVector<Type>::ConstIterator
+{
+public:
+  using pointer = typename RingVector::pointer;
+  using reference = typename RingVector::reference;
+
+  explicit Iterator() {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  reference operator*() const
+  {
+    // ugly cast, yet reduces code duplication.
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+};
+
+template <class value_type>
+RingVector <value_type> :: RingVector()
+{
+    buffer = nullptr;
+    allocated = 0;
+    head = 0;
+    n = 0;
+}
+
+template <class value_type>
+RingVector <value_type> :: RingVector(std::initializer_list<value_type> l)
+  : RingVector()
+{
+    reserve(l.size());
+    for (auto it = l.begin(); it != l.end(); it++)
+        append(*it);
+}
+
+template <class value_type>
+RingVector <value_type> :: RingVector(const RingVector& other)
+  : RingVector()
+{
+    reserve(other.n);
+    for (size_type i = 0; i < other.n; i++)
+        append(*other.slot(i));
+}
+
+template <class value_type>
+RingVector <value_type> :: RingVector(RingVector&& other)
+  : RingVector()
+{
+    swapVectors(*this, other);
+}
+
+template <class value_type>
+RingVector <value_type> :: ~RingVector()
+{
+    for (size_type i = 0; i < n; i++)
+        slot(i)->~value_type();
+    deallocateStorage(buffer);
+}
+
+template <class value_type>
+RingVector<value_type>& RingVector<value_type> :: operator=(RingVector other)
+{
+    swapVectors(*this, other);
+    return *this;
+}
+
+template <class value_type>
+void RingVector<value_type> :: swapVectors(RingVector& x, RingVector& y)
+{
+    std::swap(x.buffer, y.buffer);
+    std::swap(x.allocated, y.allocated);
+    std::swap(x.head, y.head);
+    std::swap(x.n, y.n);
+}
+
+template <class value_type>
+value_type& RingVector<value_type> :: operator[](size_type i)
+{
+    return *slot(i);
+}
+
+template <class value_type>
+const value_type& RingVector<value_type> :: operator[](size_type i) const
+{
+    return *slot(i);
+}
+
+template <class value_type>
+bool RingVector<value_type> :: isEmpty() const
+{
+    return n == 0;
+}
+
+template <class value_type>
+size_t RingVector<value_type> :: getSize() const
+{
+    return n;
+}
+
+template <class value_type>
+size_t RingVector<value_type> :: capacity() const
+{
+    return allocated;
+}
+
+// unwraps the elements into a fresh buffer so that head becomes 0
+template <class value_type>
+void RingVector<value_type> :: reallocate(size_type newCapacity)
+{
+    pointer p = allocateStorage<value_type>(newCapacity);
+    if (n != 0)
+    {
+        size_type tail = allocated - head; // slots from head to the buffer end
+        if (tail >= n) relocate(p, buffer + head, n);
+        else
+        {
+            relocate(p, buffer + head, tail);
+            relocate(p + tail, buffer, n - tail);
+        }
+    }
+    deallocateStorage(buffer);
+    buffer = p;
+    allocated = newCapacity;
+    head = 0;
+}
+
+template <class value_type>
+void RingVector<value_type> :: addMemory()
+{
+    reallocate(allocated == 0 ? 16 : 2 * allocated);
+}
+
+template <class value_type>
+void RingVector<value_type> :: reserve(size_type newCapacity)
+{
+    if (newCapacity <= allocated) return;
+    size_type rounded = 16;
+    while (rounded < newCapacity) rounded *= 2;
+    reallocate(rounded);
+}
+
+template <class value_type>
+void RingVector<value_type> :: append(const value_type& item)
+{
+    insert(cend(), item);
+}
+
+template <class value_type>
+void RingVector<value_type> :: prepend(const value_type& item)
+{
+    insert(cbegin(), item);
+}
+
+template <class value_type>
+void RingVector<value_type> :: insert(const const_iterator& insertPosition, const value_type& item)
+{
+    size_type i = insertPosition.getIndex();
+    if (i > n) throw std::out_of_range("");
+    value_type copy(item);
+    if (n == allocated) addMemory();
+
+    // shift whichever side of the insertion point is shorter
+    if (i < n - i)
+    {
+        head = (head - 1) & (allocated - 1);
+        if (i == 0) new (slot(0)) value_type(std::move(copy));
+        else
+        {
+            new (slot(0)) value_type(std::move(*slot(1)));
+            for (size_type k = 1; k < i; k++)
+                *slot(k) = std::move(*slot(k + 1));
+            *slot(i) = std::move(copy);
+        }
+    }
+    else
+    {
+        if (i == n) new (slot(n)) value_type(std::move(copy));
+        else
+        {
+            new (slot(n)) value_type(std::move(*slot(n - 1)));
+            for (size_type k = n - 1; k > i; k--)
+                *slot(k) = std::move(*slot(k - 1));
+            *slot(i) = std::move(copy);
+        }
+    }
+    n++;
+}
+
+template <class value_type>
+value_type RingVector<value_type> :: popFirst()
+{
+    if (n == 0) throw std::logic_error("vector is empty");
+    value_type item = std::move(*slot(0));
+    slot(0)->~value_type();
+    head = (head + 1) & (allocated - 1);
+    n--;
+    return item;
+}
+
+template <class value_type>
+value_type RingVector<value_type> :: popLast()
+{
+    if (n == 0) throw std::logic_error("vector is empty");
+    value_type item = std::move(*slot(n - 1));
+    slot(n - 1)->~value_type();
+    n--;
+    return item;
+}
+
+template <class value_type>
+void RingVector<value_type> :: erase(const const_iterator& position)
+{
+    if (position.getIndex() >= n) throw std::out_of_range("");
+    erase(position, position + 1);
+}
+
+template <class value_type>
+void RingVector<value_type> :: erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+{
+    size_type i = firstIncluded.getIndex();
+    size_type j = lastExcluded.getIndex();
+    if (j > n || i > j) throw std::out_of_range("there is too little elements");
+    size_type count = j - i;
+    if (count == 0) return;
+
+    // close the gap from whichever side has fewer elements to move
+    if (i < n - j)
+    {
+        for (size_type k = i; k > 0; k--)
+            *slot(k - 1 + count) = std::move(*slot(k - 1));
+        for (size_type k = 0; k < count; k++)
+            slot(k)->~value_type();
+        head = (head + count) & (allocated - 1);
+    }
+    else
+    {
+        for (size_type k = j; k < n; k++)
+            *slot(k - count) = std::move(*slot(k));
+        for (size_type k = n - count; k < n; k++)
+            slot(k)->~value_type();
+    }
+    n -= count;
+}
+
+}
+#endif // AISDI_LINEAR_RINGVECTOR_H
@@ -0,0 +1,194 @@
+#include <RingVector.h>
+
+#include <algorithm>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+namespace
+{
+
+template <typename Collection>
+void thenCollectionContainsValues(const Collection& collection, std::initializer_list<int> expected)
+{
+  BOOST_CHECK_EQUAL(collection.getSize(), expected.size());
+  BOOST_CHECK(std::equal(collection.begin(), collection.end(), expected.begin(), expected.end()));
+}
+
+// Ring whose first item sits offset slots before the end of a 16 slot
+// buffer, so the items wrap around it once there are more than offset.
+aisdi::RingVector<std::string> wrappedRing(std::size_t offset, std::size_t count, std::deque<std::string>& expected)
+{
+  aisdi::RingVector<std::string> collection;
+  collection.reserve(16);
+  for (std::size_t i = 0; i < 16 - offset; ++i)
+  {
+    collection.append("x");
+    collection.popFirst();
+  }
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    collection.append(std::to_string(i));
+    expected.push_back(std::to_string(i));
+  }
+  return collection;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(RingVectorTests)
+
+BOOST_AUTO_TEST_CASE(GivenEmptyRing_WhenPopping_ThenExceptionIsThrown)
+{
+  aisdi::RingVector<int> collection;
+
+  BOOST_CHECK(collection.isEmpty());
+  BOOST_CHECK_EQUAL(collection.capacity(), 0);
+  BOOST_CHECK(collection.begin() == collection.end());
+  BOOST_CHECK_THROW(collection.popFirst(), std::logic_error);
+  BOOST_CHECK_THROW(collection.popLast(), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(GivenRing_WhenReserving_ThenCapacityIsPowerOfTwo)
+{
+  aisdi::RingVector<int> collection;
+
+  collection.reserve(17);
+  BOOST_CHECK_EQUAL(collection.capacity(), 32);
+  collection.reserve(3);
+  BOOST_CHECK_EQUAL(collection.capacity(), 32);
+}
+
+BOOST_AUTO_TEST_CASE(GivenEmptyRing_WhenPrepending_ThenHeadWrapsToTheEndOfTheBuffer)
+{
+  aisdi::RingVector<int> collection;
+
+  collection.prepend(2);
+  collection.prepend(1);
+  collection.append(3);
+
+  thenCollectionContainsValues(collection, { 1, 2, 3 });
+  BOOST_CHECK_EQUAL(collection[0], 1);
+  BOOST_CHECK_EQUAL(collection[2], 3);
+  BOOST_CHECK_EQUAL(collection.popLast(), 3);
+  BOOST_CHECK_EQUAL(collection.popFirst(), 1);
+  thenCollectionContainsValues(collection, { 2 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenWrappedRing_WhenItGrows_ThenItemsAreUnwrappedInOrder)
+{
+  std::deque<std::string> expected;
+  auto collection = wrappedRing(5, 16, expected);
+
+  collection.append("16");
+  collection.prepend("-1");
+  expected.push_back("16");
+  expected.push_front("-1");
+
+  BOOST_CHECK_EQUAL(collection.capacity(), 32);
+  BOOST_CHECK_EQUAL(collection.getSize(), 18);
+  BOOST_CHECK(std::equal(collection.begin(), collection.end(), expected.begin(), expected.end()));
+}
+
+// Inserting and erasing shift the shorter side, which crosses the end of
+// the buffer at a different place for every offset and position.
+BOOST_AUTO_TEST_CASE(GivenWrappedRing_WhenInsertingAtEveryPosition_ThenOrderIsKept)
+{
+  for (std::size_t offset = 1; offset < 16; ++offset)
+    for (std::size_t position = 0; position <= 12; ++position)
+    {
+      std::deque<std::string> expected;
+      auto collection = wrappedRing(offset, 12, expected);
+
+      collection.insert(collection.begin() + position, "x");
+      expected.insert(expected.begin() + position, "x");
+
+      BOOST_REQUIRE(std::equal(collection.begin(), collection.end(), expected.begin(), expected.end()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GivenWrappedRing_WhenErasingRangesAtEveryPosition_ThenOrderIsKept)
+{
+  for (std::size_t offset = 1; offset < 16; ++offset)
+    for (std::size_t from = 0; from < 12; ++from)
+      for (std::size_t count : { 1, 3 })
+      {
+        std::deque<std::string> expected;
+        auto collection = wrappedRing(offset, 12, expected);
+        const std::size_t to = std::min<std::size_t>(from + count, 12);
+
+        collection.erase(collection.begin() + from, collection.begin() + to);
+        expected.erase(expected.begin() + from, expected.begin() + to);
+
+        BOOST_REQUIRE_EQUAL(collection.getSize(), expected.size());
+        BOOST_REQUIRE(std::equal(collection.begin(), collection.end(), expected.begin(), expected.end()));
+      }
+}
+
+BOOST_AUTO_TEST_CASE(GivenRing_WhenErasingOutOfRange_ThenExceptionIsThrown)
+{
+  aisdi::RingVector<int> collection = { 1, 2, 3 };
+
+  BOOST_CHECK_THROW(collection.erase(collection.end()), std::out_of_range);
+  BOOST_CHECK_THROW(collection.erase(collection.begin() + 2, collection.begin() + 1), std::out_of_range);
+  thenCollectionContainsValues(collection, { 1, 2, 3 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenRing_WhenMovingIterators_ThenTheyStayWithinTheItems)
+{
+  aisdi::RingVector<int> collection = { 1, 2, 3, 4 };
+
+  auto it = collection.begin();
+  BOOST_CHECK_EQUAL(*++it, 2);
+  BOOST_CHECK_EQUAL(*(it + 2), 4);
+  BOOST_CHECK_EQUAL(*(collection.end() - 4), 1);
+  BOOST_CHECK(collection.begin() + 4 == collection.end());
+  BOOST_CHECK_THROW(collection.end()++, std::out_of_range);
+  BOOST_CHECK_THROW(collection.begin()--, std::out_of_range);
+  BOOST_CHECK_THROW(collection.begin() + 5, std::out_of_range);
+  BOOST_CHECK_THROW(collection.end() - 5, std::out_of_range);
+  BOOST_CHECK_THROW(*collection.end(), std::out_of_range);
+
+  *collection.begin() = 9;
+  for (auto& item : collection) item += 1;
+  thenCollectionContainsValues(collection, { 10, 3, 4, 5 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenWrappedRing_WhenCopyingAndMoving_ThenItemsFollow)
+{
+  std::deque<std::string> expected;
+  auto collection = wrappedRing(3, 10, expected);
+
+  aisdi::RingVector<std::string> copy(collection);
+  aisdi::RingVector<std::string> moved(std::move(collection));
+  aisdi::RingVector<std::string> assigned;
+  assigned = copy;
+  copy.popFirst();
+
+  BOOST_CHECK(collection.isEmpty());
+  BOOST_CHECK(std::equal(moved.begin(), moved.end(), expected.begin(), expected.end()));
+  BOOST_CHECK(std::equal(assigned.begin(), assigned.end(), expected.begin(), expected.end()));
+  BOOST_CHECK_EQUAL(copy[0], "1");
+}
+
+BOOST_AUTO_TEST_CASE(GivenWrappedRingDestroyedWithItems_WhenDestroyed_ThenItemsAreReleased)
+{
+  auto counter = std::make_shared<int>(0);
+  {
+    aisdi::RingVector<std::shared_ptr<int>> collection;
+    for (int i = 0; i < 10; ++i) collection.append(counter);
+    for (int i = 0; i < 10; ++i) collection.popFirst();
+    for (int i = 0; i < 12; ++i) collection.append(counter);
+    collection.erase(collection.begin() + 3);
+    BOOST_CHECK_EQUAL(counter.use_count(), 12);
+  }
+  BOOST_CHECK_EQUAL(counter.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,269 @@
+#ifndef AISDI_LINEAR_SERIALIZATION_H
+#define AISDI_LINEAR_SERIALIZATION_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "LinkedList.h"
+#include "Memory.h"
+#include "Vector.h"
+
+namespace aisdi
+{
+
+// Versioned binary format for containers of trivially copyable items,
+// written to and read from a file descriptor (file, pipe or socket).
+//
+// Every stream starts with a 32 byte header: magic, format version, a byte
+// order mark, the layout, the item size and the item count. The items follow
+// byte for byte as they lie in memory, so a stream is only readable on a
+// machine with the same byte order and item layout; the header makes any
+// other reader fail instead of misreading.
+//
+// A Vector is one contiguous run of items: it goes out in a single writev
+// (header and buffer together) and comes back with a single read straight
+// into the vector's own storage. A LinkedList is streamed in frames, each a
+// 4 byte count followed by up to frameBytes of items: the nodes are copied
+// into one frame buffer at a time (and appended from it when reading), so
+// the list is never copied as a whole. Gathering the nodes with one iovec
+// each was tried and is several times slower, as the kernel then copies
+// item by item.
+//
+// Short writes and reads are resumed; errors throw std::system_error, and
+// streams that are not ours, of another version or cut short throw
+// std::runtime_error.
+
+namespace serialization
+{
+
+constexpr std::uint32_t formatVersion = 1;
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+constexpr std::size_t frameBytes = 64 * 1024;
+
+template <typename Type>
+constexpr std::size_t frameItems()
+{
+    return frameBytes / sizeof(Type) > 0 ? frameBytes / sizeof(Type) : 1;
+}
+
+enum class Layout : std::uint32_t { Contiguous = 1, Frames = 2 };
+
+struct Header
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byteOrder;
+  std::uint32_t layout;
+  std::uint32_t itemSize;
+  std::uint64_t count;
+};
+static_assert(sizeof(Header) == 32, "the header is 32 bytes on every platform");
+
+inline const char* magic()
+{
+    return "AISDIBIN";
+}
+
+inline Header makeHeader(Layout layout, std::size_t itemSize, std::size_t count)
+{
+    Header header;
+    std::memcpy(header.magic, magic(), sizeof(header.magic));
+    header.version = formatVersion;
+    header.byteOrder = byteOrderMark;
+    header.layout = static_cast<std::uint32_t>(layout);
+    header.itemSize = static_cast<std::uint32_t>(itemSize);
+    header.count = count;
+    return header;
+}
+
+// Writes every byte the iovecs describe, resuming after short writes. The
+// iovecs are used up in the process.
+inline void writeAll(int fd, iovec* parts, int count)
+{
+    while (count > 0)
+    {
+        const ssize_t written = writev(fd, parts, count);
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "cannot write the stream");
+        }
+        std::size_t left = static_cast<std::size_t>(written);
+        while (count > 0 && left >= parts->iov_len)
+        {
+            left -= parts->iov_len;
+            parts++;
+            count--;
+        }
+        if (count > 0)
+        {
+            parts->iov_base = static_cast<char*>(parts->iov_base) + left;
+            parts->iov_len -= left;
+        }
+    }
+}
+
+inline void readAll(int fd, void* to, std::size_t bytes)
+{
+    char* position = static_cast<char*>(to);
+    while (bytes > 0)
+    {
+        const ssize_t got = read(fd, position, bytes);
+        if (got < 0)
+        {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "cannot read the stream");
+        }
+        if (got == 0) throw std::runtime_error("stream is cut short");
+        position += got;
+        bytes -= static_cast<std::size_t>(got);
+    }
+}
+
+inline Header readHeader(int fd, Layout layout, std::size_t itemSize)
+{
+    Header header;
+    readAll(fd, &header, sizeof(header));
+    if (std::memcmp(header.magic, magic(), sizeof(header.magic)) != 0)
+        throw std::runtime_error("stream does not hold a serialized container");
+    if (header.version != formatVersion)
+        throw std::runtime_error("stream has an unknown format version");
+    if (header.byteOrder != byteOrderMark)
+        throw std::runtime_error("stream was written with another byte order");
+    if (header.layout != static_cast<std::uint32_t>(layout))
+        throw std::runtime_error("stream holds another kind of container");
+    if (header.itemSize != itemSize)
+        throw std::runtime_error("stream holds items of another size");
+    return header;
+}
+
+// A regular file has to hold the bytes a header promises, so a corrupt count
+// fails here instead of allocating for items that are not there. Pipes and
+// sockets cannot tell; a short one fails in readAll.
+inline void checkRemaining(int fd, std::size_t bytes)
+{
+    struct stat status;
+    if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode)) return;
+    const off_t position = lseek(fd, 0, SEEK_CUR);
+    if (position < 0 || position > status.st_size) return;
+    if (bytes > static_cast<std::uint64_t>(status.st_size - position))
+        throw std::runtime_error("stream is cut short");
+}
+
+// Owns the frame buffer of one list read or write.
+template <typename Type>
+class FrameBuffer
+{
+private:
+  Type* items;
+
+public:
+  FrameBuffer()
+    : items(allocateStorage<Type>(frameItems<Type>()))
+  {}
+
+  FrameBuffer(const FrameBuffer&) = delete;
+  FrameBuffer& operator=(const FrameBuffer&) = delete;
+
+  ~FrameBuffer()
+  {
+    deallocateStorage(items);
+  }
+
+  Type* data() const
+  {
+    return items;
+  }
+};
+
+}
+
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void writeBinary(int fd, const Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items)
+{
+    static_assert(std::is_trivially_copyable<Type>::value, "only trivially copyable items are written byte for byte");
+    serialization::Header header = serialization::makeHeader(serialization::Layout::Contiguous, sizeof(Type),
+                                                             items.getSize());
+    iovec parts[2] = { { &header, sizeof(header) },
+                       { const_cast<Type*>(items.data()), items.getSize() * sizeof(Type) } };
+    serialization::writeAll(fd, parts, 2);
+}
+
+// Appends the stream's items to items.
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void readBinary(int fd, Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items)
+{
+    static_assert(std::is_trivially_copyable<Type>::value, "only trivially copyable items are read byte for byte");
+    const serialization::Header header = serialization::readHeader(fd, serialization::Layout::Contiguous, sizeof(Type));
+    const std::uint64_t room = std::numeric_limits<std::size_t>::max() / sizeof(Type) - items.getSize();
+    if (header.count > room) throw std::runtime_error("stream claims more items than memory can hold");
+    const std::size_t count = static_cast<std::size_t>(header.count);
+    serialization::checkRemaining(fd, count * sizeof(Type));
+    Type* target = items.appendUninitialized(count);
+    try
+    {
+        serialization::readAll(fd, target, count * sizeof(Type));
+    }
+    catch (...)
+    {
+        items.erase(items.cend() - count, items.cend());
+        throw;
+    }
+}
+
+template <typename Type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void writeBinary(int fd, const LinkedList<Type, NodeAllocator, Instrumentation, Checking, Indexing>& items)
+{
+    static_assert(std::is_trivially_copyable<Type>::value, "only trivially copyable items are written byte for byte");
+    serialization::Header header = serialization::makeHeader(serialization::Layout::Frames, sizeof(Type),
+                                                             items.getSize());
+    iovec headerPart = { &header, sizeof(header) };
+    serialization::writeAll(fd, &headerPart, 1);
+
+    serialization::FrameBuffer<Type> frame;
+    auto item = items.cbegin();
+    for (std::size_t left = items.getSize(); left > 0;)
+    {
+        std::uint32_t frameCount = static_cast<std::uint32_t>(std::min(left, serialization::frameItems<Type>()));
+        for (std::uint32_t i = 0; i < frameCount; i++, ++item)
+            std::memcpy(static_cast<void*>(frame.data() + i), &*item, sizeof(Type));
+        iovec parts[2] = { { &frameCount, sizeof(frameCount) }, { frame.data(), frameCount * sizeof(Type) } };
+        serialization::writeAll(fd, parts, 2);
+        left -= frameCount;
+    }
+}
+
+// Appends the stream's items to items. They are read into a list of their
+// own first, so a broken or cut short stream leaves items as it was.
+template <typename Type, template <typename> class NodeAllocator, class Instrumentation, class Checking, class Indexing>
+void readBinary(int fd, LinkedList<Type, NodeAllocator, Instrumentation, Checking, Indexing>& items)
+{
+    static_assert(std::is_trivially_copyable<Type>::value, "only trivially copyable items are read byte for byte");
+    const serialization::Header header = serialization::readHeader(fd, serialization::Layout::Frames, sizeof(Type));
+    serialization::FrameBuffer<Type> frame;
+    LinkedList<Type, NodeAllocator, Instrumentation, Checking, Indexing> read;
+    for (std::uint64_t left = header.count; left > 0;)
+    {
+        std::uint32_t frameCount;
+        serialization::readAll(fd, &frameCount, sizeof(frameCount));
+        if (frameCount == 0 || frameCount > serialization::frameItems<Type>() || frameCount > left)
+            throw std::runtime_error("stream has a broken frame");
+        serialization::readAll(fd, frame.data(), frameCount * sizeof(Type));
+        for (std::uint32_t i = 0; i < frameCount; i++)
+            read.append(frame.data()[i]);
+        left -= frameCount;
+    }
+    items.concat(read);
+}
+
+}
+#endif // AISDI_LINEAR_SERIALIZATION_H
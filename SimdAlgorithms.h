@@ -0,0 +1,723 @@
+#ifndef AISDI_LINEAR_SIMDALGORITHMS_H
+#define AISDI_LINEAR_SIMDALGORITHMS_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "Vector.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AISDI_SIMD_X86 1
+#define AISDI_SIMD_TARGET(features) __attribute__((target(features)))
+#include <immintrin.h>
+#endif
+
+namespace aisdi
+{
+
+// Search and reduction over contiguous items: find, count, contains,
+// minimum, maximum and sum. The kernels for int32_t, uint64_t and (sum only)
+// std::complex<int32_t> come in SSE2, AVX2 and AVX-512 flavours, picked at
+// run time from what the CPU supports; every other type, and every CPU
+// without those, goes through the scalar loops. All levels give exactly the
+// same results.
+
+enum class SimdLevel { Scalar, Sse2, Avx2, Avx512 };
+
+// Best level the running CPU supports, detected once.
+inline SimdLevel detectSimdLevel()
+{
+#ifdef AISDI_SIMD_X86
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return SimdLevel::Avx512;
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+        if (__builtin_cpu_supports("sse2")) return SimdLevel::Sse2;
+        return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+// Sums are accumulated in a type wide enough not to overflow on real inputs.
+template <typename Type>
+struct SumOf
+{
+  using type = Type;
+};
+
+template <>
+struct SumOf<std::int32_t>
+{
+  using type = std::int64_t;
+};
+
+template <>
+struct SumOf<std::complex<std::int32_t>>
+{
+  using type = std::complex<std::int64_t>;
+};
+
+namespace simd
+{
+
+// Scalar kernels, for any type. find returns n when value is missing;
+// minimum and maximum need n > 0.
+
+template <typename Type>
+std::size_t find(const Type* items, std::size_t n, const Type& value, SimdLevel = SimdLevel::Scalar)
+{
+    std::size_t i = 0;
+    while (i < n && !(items[i] == value)) i++;
+    return i;
+}
+
+template <typename Type>
+std::size_t count(const Type* items, std::size_t n, const Type& value, SimdLevel = SimdLevel::Scalar)
+{
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < n; i++)
+        if (items[i] == value) result++;
+    return result;
+}
+
+template <bool Maximum, typename Type>
+Type extreme(const Type* items, std::size_t n, SimdLevel = SimdLevel::Scalar)
+{
+    Type best = items[0];
+    for (std::size_t i = 1; i < n; i++)
+        if (Maximum ? best < items[i] : items[i] < best) best = items[i];
+    return best;
+}
+
+template <typename Type>
+typename SumOf<Type>::type sum(const Type* items, std::size_t n, SimdLevel = SimdLevel::Scalar)
+{
+    typename SumOf<Type>::type result = typename SumOf<Type>::type();
+    for (std::size_t i = 0; i < n; i++)
+        result += static_cast<typename SumOf<Type>::type>(items[i]);
+    return result;
+}
+
+template <typename Type>
+std::complex<std::int64_t> sumComplex(const std::complex<Type>* items, std::size_t n)
+{
+    std::int64_t re = 0, im = 0;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        re += items[i].real();
+        im += items[i].imag();
+    }
+    return std::complex<std::int64_t>(re, im);
+}
+
+#ifdef AISDI_SIMD_X86
+
+// SSE2
+
+AISDI_SIMD_TARGET("sse2")
+inline std::size_t findSse2(const std::int32_t* items, std::size_t n, std::int32_t value)
+{
+    const __m128i needle = _mm_set1_epi32(value);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(items + i)), needle);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return i + find(items + i, n - i, value);
+}
+
+AISDI_SIMD_TARGET("sse2")
+inline std::size_t countSse2(const std::int32_t* items, std::size_t n, std::int32_t value)
+{
+    const __m128i needle = _mm_set1_epi32(value);
+    const std::size_t end = n - n % 4;
+    std::size_t result = 0, i = 0;
+    while (i < end)
+    {
+        // 32-bit lane counters, emptied before they could overflow
+        const std::size_t stop = end - i > (std::size_t(1) << 30) ? i + (std::size_t(1) << 30) : end;
+        __m128i counts = _mm_setzero_si128();
+        for (; i < stop; i += 4)
+            counts = _mm_sub_epi32(counts, _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(items + i)), needle));
+        alignas(16) std::uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), counts);
+        result += std::size_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+    return result + count(items + i, n - i, value);
+}
+
+template <bool Maximum>
+AISDI_SIMD_TARGET("sse2")
+std::int32_t extremeSse2(const std::int32_t* items, std::size_t n)
+{
+    __m128i best = _mm_set1_epi32(items[0]);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(items + i));
+        __m128i takeV = Maximum ? _mm_cmpgt_epi32(v, best) : _mm_cmpgt_epi32(best, v);
+        best = _mm_or_si128(_mm_and_si128(takeV, v), _mm_andnot_si128(takeV, best));
+    }
+    alignas(16) std::int32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), best);
+    std::int32_t result = extreme<Maximum>(lanes, 4);
+    if (i < n)
+    {
+        std::int32_t rest = extreme<Maximum>(items + i, n - i);
+        if (Maximum ? result < rest : rest < result) result = rest;
+    }
+    return result;
+}
+
+// sign extends 4 int32 lanes into two registers of int64 and adds them to acc
+AISDI_SIMD_TARGET("sse2")
+inline __m128i addWidenedSse2(__m128i acc, __m128i v)
+{
+    __m128i sign = _mm_srai_epi32(v, 31);
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+    return _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+}
+
+AISDI_SIMD_TARGET("sse2")
+inline std::int64_t sumSse2(const std::int32_t* items, std::size_t n)
+{
+    __m128i acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        acc = addWidenedSse2(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(items + i)));
+    alignas(16) std::int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + sum(items + i, n - i);
+}
+
+// 64-bit equality out of 32-bit compares: both halves have to match
+AISDI_SIMD_TARGET("sse2")
+inline __m128i equal64Sse2(__m128i a, __m128i b)
+{
+    __m128i eq = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+AISDI_SIMD_TARGET("sse2")
+inline std::size_t findSse2(const std::uint64_t* items, std::size_t n, std::uint64_t value)
+{
+    const __m128i needle = _mm_set1_epi64x(static_cast<long long>(value));
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128i eq = equal64Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(items + i)), needle);
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(eq));
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return i + find(items + i, n - i, value);
+}
+
+AISDI_SIMD_TARGET("sse2")
+inline std::size_t countSse2(const std::uint64_t* items, std::size_t n, std::uint64_t value)
+{
+    const __m128i needle = _mm_set1_epi64x(static_cast<long long>(value));
+    __m128i counts = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        counts = _mm_sub_epi64(counts, equal64Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(items + i)), needle));
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), counts);
+    return lanes[0] + lanes[1] + count(items + i, n - i, value);
+}
+
+AISDI_SIMD_TARGET("sse2")
+inline std::uint64_t sumSse2(const std::uint64_t* items, std::size_t n)
+{
+    __m128i acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        acc = _mm_add_epi64(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(items + i)));
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + sum(items + i, n - i);
+}
+
+// a pair of complex items is 4 int32 lanes: re, im, re, im
+AISDI_SIMD_TARGET("sse2")
+inline std::complex<std::int64_t> sumSse2(const std::complex<std::int32_t>* items, std::size_t n)
+{
+    const std::int32_t* parts = reinterpret_cast<const std::int32_t*>(items);
+    __m128i acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        acc = addWidenedSse2(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(parts + 2 * i)));
+    alignas(16) std::int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return std::complex<std::int64_t>(lanes[0], lanes[1]) + sumComplex(items + i, n - i);
+}
+
+// AVX2
+
+AISDI_SIMD_TARGET("avx2")
+inline std::size_t findAvx2(const std::int32_t* items, std::size_t n, std::int32_t value)
+{
+    const __m256i needle = _mm256_set1_epi32(value);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(items + i)), needle);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return i + find(items + i, n - i, value);
+}
+
+AISDI_SIMD_TARGET("avx2,popcnt")
+inline std::size_t countAvx2(const std::int32_t* items, std::size_t n, std::int32_t value)
+{
+    const __m256i needle = _mm256_set1_epi32(value);
+    std::size_t result = 0, i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(items + i)), needle);
+        result += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+    }
+    return result + count(items + i, n - i, value);
+}
+
+template <bool Maximum>
+AISDI_SIMD_TARGET("avx2")
+std::int32_t extremeAvx2(const std::int32_t* items, std::size_t n)
+{
+    __m256i best = _mm256_set1_epi32(items[0]);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(items + i));
+        best = Maximum ? _mm256_max_epi32(best, v) : _mm256_min_epi32(best, v);
+    }
+    alignas(32) std::int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), best);
+    std::int32_t result = extreme<Maximum>(lanes, 8);
+    if (i < n)
+    {
+        std::int32_t rest = extreme<Maximum>(items + i, n - i);
+        if (Maximum ? result < rest : rest < result) result = rest;
+    }
+    return result;
+}
+
+AISDI_SIMD_TARGET("avx2")
+inline std::int64_t sumAvx2(const std::int32_t* items, std::size_t n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(items + i))));
+    alignas(32) std::int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum(items + i, n - i);
+}
+
+AISDI_SIMD_TARGET("avx2")
+inline std::size_t findAvx2(const std::uint64_t* items, std::size_t n, std::uint64_t value)
+{
+    const __m256i needle = _mm256_set1_epi64x(static_cast<long long>(value));
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(items + i)), needle);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return i + find(items + i, n - i, value);
+}
+
+AISDI_SIMD_TARGET("avx2,popcnt")
+inline std::size_t countAvx2(const std::uint64_t* items, std::size_t n, std::uint64_t value)
+{
+    const __m256i needle = _mm256_set1_epi64x(static_cast<long long>(value));
+    std::size_t result = 0, i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(items + i)), needle);
+        result += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+    }
+    return result + count(items + i, n - i, value);
+}
+
+// AVX2 only compares signed 64-bit lanes, flipping the sign bit maps the
+// unsigned order onto the signed one
+template <bool Maximum>
+AISDI_SIMD_TARGET("avx2")
+std::uint64_t extremeAvx2(const std::uint64_t* items, std::size_t n)
+{
+    const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+    __m256i best = _mm256_set1_epi64x(static_cast<long long>(items[0]));
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(items + i));
+        __m256i biasedV = _mm256_xor_si256(v, bias), biasedBest = _mm256_xor_si256(best, bias);
+        __m256i takeV = Maximum ? _mm256_cmpgt_epi64(biasedV, biasedBest) : _mm256_cmpgt_epi64(biasedBest, biasedV);
+        best = _mm256_blendv_epi8(best, v, takeV);
+    }
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), best);
+    std::uint64_t result = extreme<Maximum>(lanes, 4);
+    if (i < n)
+    {
+        std::uint64_t rest = extreme<Maximum>(items + i, n - i);
+        if (Maximum ? result < rest : rest < result) result = rest;
+    }
+    return result;
+}
+
+AISDI_SIMD_TARGET("avx2")
+inline std::uint64_t sumAvx2(const std::uint64_t* items, std::size_t n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(items + i)));
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum(items + i, n - i);
+}
+
+AISDI_SIMD_TARGET("avx2")
+inline std::complex<std::int64_t> sumAvx2(const std::complex<std::int32_t>* items, std::size_t n)
+{
+    const std::int32_t* parts = reinterpret_cast<const std::int32_t*>(items);
+    __m256i acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(parts + 2 * i))));
+    alignas(32) std::int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return std::complex<std::int64_t>(lanes[0] + lanes[2], lanes[1] + lanes[3]) + sumComplex(items + i, n - i);
+}
+
+// AVX-512 (F only). GCC's own intrinsic headers trip -Wuninitialized here
+// (the self-initialized _mm512_undefined_* placeholders), hence the pragma.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+AISDI_SIMD_TARGET("avx512f")
+inline std::size_t findAvx512(const std::int32_t* items, std::size_t n, std::int32_t value)
+{
+    const __m512i needle = _mm512_set1_epi32(value);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __mmask16 mask = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(items + i), needle);
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return i + find(items + i, n - i, value);
+}
+
+AISDI_SIMD_TARGET("avx512f,popcnt")
+inline std::size_t countAvx512(const std::int32_t* items, std::size_t n, std::int32_t value)
+{
+    const __m512i needle = _mm512_set1_epi32(value);
+    std::size_t result = 0, i = 0;
+    for (; i + 16 <= n; i += 16)
+        result += __builtin_popcount(_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(items + i), needle));
+    return result + count(items + i, n - i, value);
+}
+
+template <bool Maximum>
+AISDI_SIMD_TARGET("avx512f")
+std::int32_t extremeAvx512(const std::int32_t* items, std::size_t n)
+{
+    __m512i best = _mm512_set1_epi32(items[0]);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512i v = _mm512_loadu_si512(items + i);
+        best = Maximum ? _mm512_max_epi32(best, v) : _mm512_min_epi32(best, v);
+    }
+    std::int32_t result = Maximum ? _mm512_reduce_max_epi32(best) : _mm512_reduce_min_epi32(best);
+    if (i < n)
+    {
+        std::int32_t rest = extreme<Maximum>(items + i, n - i);
+        if (Maximum ? result < rest : rest < result) result = rest;
+    }
+    return result;
+}
+
+AISDI_SIMD_TARGET("avx512f")
+inline std::int64_t sumAvx512(const std::int32_t* items, std::size_t n)
+{
+    __m512i acc = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(items + i))));
+    return _mm512_reduce_add_epi64(acc) + sum(items + i, n - i);
+}
+
+AISDI_SIMD_TARGET("avx512f")
+inline std::size_t findAvx512(const std::uint64_t* items, std::size_t n, std::uint64_t value)
+{
+    const __m512i needle = _mm512_set1_epi64(static_cast<long long>(value));
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __mmask8 mask = _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(items + i), needle);
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return i + find(items + i, n - i, value);
+}
+
+AISDI_SIMD_TARGET("avx512f,popcnt")
+inline std::size_t countAvx512(const std::uint64_t* items, std::size_t n, std::uint64_t value)
+{
+    const __m512i needle = _mm512_set1_epi64(static_cast<long long>(value));
+    std::size_t result = 0, i = 0;
+    for (; i + 8 <= n; i += 8)
+        result += __builtin_popcount(_mm512_cmpeq_epi64_mask(_mm512_loadu_si512(items + i), needle));
+    return result + count(items + i, n - i, value);
+}
+
+template <bool Maximum>
+AISDI_SIMD_TARGET("avx512f")
+std::uint64_t extremeAvx512(const std::uint64_t* items, std::size_t n)
+{
+    __m512i best = _mm512_set1_epi64(static_cast<long long>(items[0]));
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512i v = _mm512_loadu_si512(items + i);
+        best = Maximum ? _mm512_max_epu64(best, v) : _mm512_min_epu64(best, v);
+    }
+    std::uint64_t result = Maximum ? _mm512_reduce_max_epu64(best) : _mm512_reduce_min_epu64(best);
+    if (i < n)
+    {
+        std::uint64_t rest = extreme<Maximum>(items + i, n - i);
+        if (Maximum ? result < rest : rest < result) result = rest;
+    }
+    return result;
+}
+
+AISDI_SIMD_TARGET("avx512f")
+inline std::uint64_t sumAvx512(const std::uint64_t* items, std::size_t n)
+{
+    __m512i acc = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        acc = _mm512_add_epi64(acc, _mm512_loadu_si512(items + i));
+    return static_cast<std::uint64_t>(_mm512_reduce_add_epi64(acc)) + sum(items + i, n - i);
+}
+
+// lanes alternate re, im; the odd/even lanes are added up separately
+AISDI_SIMD_TARGET("avx512f")
+inline std::complex<std::int64_t> sumAvx512(const std::complex<std::int32_t>* items, std::size_t n)
+{
+    const std::int32_t* parts = reinterpret_cast<const std::int32_t*>(items);
+    __m512i acc = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(parts + 2 * i))));
+    std::int64_t re = _mm512_mask_reduce_add_epi64(0x55, acc);
+    std::int64_t im = _mm512_mask_reduce_add_epi64(0xAA, acc);
+    return std::complex<std::int64_t>(re, im) + sumComplex(items + i, n - i);
+}
+
+#pragma GCC diagnostic pop
+
+#endif // AISDI_SIMD_X86
+
+// Dispatch for the vectorized types. A level above what the CPU supports is
+// lowered to the supported one.
+
+inline SimdLevel usableLevel(SimdLevel level)
+{
+    SimdLevel supported = detectSimdLevel();
+    return level < supported ? level : supported;
+}
+
+inline std::size_t find(const std::int32_t* items, std::size_t n, std::int32_t value, SimdLevel level)
+{
+#ifdef AISDI_SIMD_X86
+    switch (usableLevel(level))
+    {
+    case SimdLevel::Avx512: return findAvx512(items, n, value);
+    case SimdLevel::Avx2: return findAvx2(items, n, value);
+    case SimdLevel::Sse2: return findSse2(items, n, value);
+    default: break;
+    }
+#endif
+    return find<std::int32_t>(items, n, value);
+}
+
+inline std::size_t find(const std::uint64_t* items, std::size_t n, std::uint64_t value, SimdLevel level)
+{
+#ifdef AISDI_SIMD_X86
+    switch (usableLevel(level))
+    {
+    case SimdLevel::Avx512: return findAvx512(items, n, value);
+    case SimdLevel::Avx2: return findAvx2(items, n, value);
+    case SimdLevel::Sse2: return findSse2(items, n, value);
+    default: break;
+    }
+#endif
+    return find<std::uint64_t>(items, n, value);
+}
+
+inline std::size_t count(const std::int32_t* items, std::size_t n, std::int32_t value, SimdLevel level)
+{
+#ifdef AISDI_SIMD_X86
+    switch (usableLevel(level))
+    {
+    case SimdLevel::Avx512: return countAvx512(items, n, value);
+    case SimdLevel::Avx2: return countAvx2(items, n, value);
+    case SimdLevel::Sse2: return countSse2(items, n, value);
+    default: break;
+    }
+#endif
+    return count<std::int32_t>(items, n, value);
+}
+
+inline std::size_t count(const std::uint64_t* items, std::size_t n, std::uint64_t value, SimdLevel level)
+{
+#ifdef AISDI_SIMD_X86
+    switch (usableLevel(level))
+    {
+    case SimdLevel::Avx512: return countAvx512(items, n, value);
+    case SimdLevel::Avx2: return countAvx2(items, n, value);
+    case SimdLevel::Sse2: return countSse2(items, n, value);
+    default: break;
+    }
+#endif
+    return count<std::uint64_t>(items, n, value);
+}
+
+// SSE2 has no packed min/max for these lanes that would beat the scalar
+// loop for uint64_t, so that combination stays scalar.
+template <bool Maximum>
+std::int32_t extreme(const std::int32_t* items, std::size_t n, SimdLevel level)
+{
+#ifdef AISDI_SIMD_X86
+    switch (usableLevel(level))
+    {
+    case SimdLevel::Avx512: return extremeAvx512<Maximum>(items, n);
+    case SimdLevel::Avx2: return extremeAvx2<Maximum>(items, n);
+    case SimdLevel::Sse2: return extremeSse2<Maximum>(items, n);
+    default: break;
+    }
+#endif
+    return extreme<Maximum, std::int32_t>(items, n);
+}
+
+template <bool Maximum>
+std::uint64_t extreme(const std::uint64_t* items, std::size_t n, SimdLevel level)
+{
+#ifdef AISDI_SIMD_X86
+    switch (usableLevel(level))
+    {
+    case SimdLevel::Avx512: return extremeAvx512<Maximum>(items, n);
+    case SimdLevel::Avx2: return extremeAvx2<Maximum>(items, n);
+    default: break;
+    }
+#endif
+    return extreme<Maximum, std::uint64_t>(items, n);
+}
+
+inline std::int64_t sum(const std::int32_t* items, std::size_t n, SimdLevel level)
+{
+#ifdef AISDI_SIMD_X86
+    switch (usableLevel(level))
+    {
+    case SimdLevel::Avx512: return sumAvx512(items, n);
+    case SimdLevel::Avx2: return sumAvx2(items, n);
+    case SimdLevel::Sse2: return sumSse2(items, n);
+    default: break;
+    }
+#endif
+    return sum<std::int32_t>(items, n);
+}
+
+inline std::uint64_t sum(const std::uint64_t* items, std::size_t n, SimdLevel level)
+{
+#ifdef AISDI_SIMD_X86
+    switch (usableLevel(level))
+    {
+    case SimdLevel::Avx512: return sumAvx512(items, n);
+    case SimdLevel::Avx2: return sumAvx2(items, n);
+    case SimdLevel::Sse2: return sumSse2(items, n);
+    default: break;
+    }
+#endif
+    return sum<std::uint64_t>(items, n);
+}
+
+inline std::complex<std::int64_t> sum(const std::complex<std::int32_t>* items, std::size_t n, SimdLevel level)
+{
+#ifdef AISDI_SIMD_X86
+    switch (usableLevel(level))
+    {
+    case SimdLevel::Avx512: return sumAvx512(items, n);
+    case SimdLevel::Avx2: return sumAvx2(items, n);
+    case SimdLevel::Sse2: return sumSse2(items, n);
+    default: break;
+    }
+#endif
+    return sumComplex(items, n);
+}
+
+}
+
+// Vector front ends. The value is taken as the vector's value_type, so that
+// e.g. count(v, 5) works for a Vector<uint64_t>.
+
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+typename Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>::const_iterator
+find(const Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items,
+     const typename Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>::value_type& value,
+     SimdLevel level = detectSimdLevel())
+{
+    return items.cbegin() + simd::find(items.data(), items.getSize(), value, level);
+}
+
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+std::size_t count(const Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items,
+                  const typename Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>::value_type& value,
+                  SimdLevel level = detectSimdLevel())
+{
+    return simd::count(items.data(), items.getSize(), value, level);
+}
+
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+bool contains(const Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items,
+              const typename Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>::value_type& value,
+              SimdLevel level = detectSimdLevel())
+{
+    return simd::find(items.data(), items.getSize(), value, level) != items.getSize();
+}
+
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+Type minimum(const Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items, SimdLevel level = detectSimdLevel())
+{
+    if (items.isEmpty()) throw std::logic_error("vector is empty");
+    return simd::extreme<false>(items.data(), items.getSize(), level);
+}
+
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+Type maximum(const Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items, SimdLevel level = detectSimdLevel())
+{
+    if (items.isEmpty()) throw std::logic_error("vector is empty");
+    return simd::extreme<true>(items.data(), items.getSize(), level);
+}
+
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+typename SumOf<Type>::type sum(const Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items,
+                               SimdLevel level = detectSimdLevel())
+{
+    return simd::sum(items.data(), items.getSize(), level);
+}
+
+}
+#endif // AISDI_LINEAR_SIMDALGORITHMS_H
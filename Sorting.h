@@ -0,0 +1,273 @@
+#ifndef AISDI_LINEAR_SORTING_H
+#define AISDI_LINEAR_SORTING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Memory.h"
+#include "ThreadPool.h"
+#include "Vector.h"
+
+namespace aisdi
+{
+
+namespace sorting
+{
+
+// Below this many items per task, work is not worth splitting further.
+constexpr std::size_t grain = 16384;
+
+// Merge path split: how many of the first d items of merge(a, b) come from
+// a. Ties go to a, as in std::merge, which keeps the split merges stable.
+template <typename Type, typename Compare>
+std::size_t mergeSplit(const Type* a, std::size_t na, const Type* b, std::size_t nb, std::size_t d, Compare& compare)
+{
+    std::size_t low = d > nb ? d - nb : 0;
+    std::size_t high = d < na ? d : na;
+    while (low < high)
+    {
+        std::size_t i = low + (high - low) / 2;
+        if (compare(b[d - i - 1], a[i])) high = i;
+        else low = i + 1;
+    }
+    return low;
+}
+
+// Runs this short are sorted by insertion before any merging.
+constexpr std::size_t smallRun = 32;
+
+// Stable insertion sort. The item being placed is held aside while the larger
+// ones shift up; if compare throws, it goes back into the hole it left.
+template <typename Type, typename Compare>
+void insertionSort(Type* items, std::size_t n, Compare& compare)
+{
+    for (std::size_t i = 1; i < n; i++)
+    {
+        if (!compare(items[i], items[i - 1])) continue;
+        Type item = std::move(items[i]);
+        std::size_t hole = i;
+        try
+        {
+            do
+            {
+                items[hole] = std::move(items[hole - 1]);
+                hole--;
+            }
+            while (hole > 0 && compare(item, items[hole - 1]));
+        }
+        catch (...)
+        {
+            items[hole] = std::move(item);
+            throw;
+        }
+        items[hole] = std::move(item);
+    }
+}
+
+// Moves merge(a, b) into out. If compare throws, what is left of a and b is
+// moved after what was merged, so out still ends up with every item.
+template <typename Type, typename Compare>
+void mergeMoving(Type* a, std::size_t na, Type* b, std::size_t nb, Type* out, Compare& compare)
+{
+    std::size_t i = 0, j = 0;
+    try
+    {
+        while (i < na && j < nb)
+        {
+            if (compare(b[j], a[i])) *out++ = std::move(b[j++]);
+            else *out++ = std::move(a[i++]);
+        }
+    }
+    catch (...)
+    {
+        std::move(b + j, b + nb, std::move(a + i, a + na, out));
+        throw;
+    }
+    std::move(b + j, b + nb, std::move(a + i, a + na, out));
+}
+
+// Moves merge(a, b) into out, cut into independent pieces when it is large.
+// Every item ends up in out even if compare throws.
+template <typename Type, typename Compare>
+void mergeRuns(Type* a, std::size_t na, Type* b, std::size_t nb, Type* out, Compare& compare, ThreadPool& pool)
+{
+    const std::size_t total = na + nb;
+    std::size_t pieces = std::min(total / grain, pool.getThreadCount());
+    if (pieces <= 1)
+    {
+        mergeMoving(a, na, b, nb, out, compare);
+        return;
+    }
+    // all splits are found before any piece starts moving items out of a and b
+    std::vector<std::size_t> splits(pieces + 1);
+    try
+    {
+        for (std::size_t piece = 0; piece <= pieces; piece++)
+            splits[piece] = mergeSplit(a, na, b, nb, total * piece / pieces, compare);
+    }
+    catch (...)
+    {
+        std::move(b, b + nb, std::move(a, a + na, out));
+        throw;
+    }
+    pool.forEachIndex(pieces, [&](std::size_t piece) {
+        const std::size_t from = total * piece / pieces, to = total * (piece + 1) / pieces;
+        const std::size_t i = splits[piece], j = splits[piece + 1];
+        mergeMoving(a + i, j - i, b + from - i, (to - j) - (from - i), out + from, compare);
+    });
+}
+
+// Merges the sorted runs of width items in source pairwise into target. If
+// compare throws, the pairs not merged yet are moved over as they are, so
+// target holds every item either way.
+template <typename Type, typename Compare>
+void mergeRound(Type* source, Type* target, std::size_t n, std::size_t width, Compare& compare)
+{
+    std::size_t low = 0;
+    try
+    {
+        for (; low < n; low += 2 * width)
+        {
+            const std::size_t middle = std::min(low + width, n), high = std::min(low + 2 * width, n);
+            mergeMoving(source + low, middle - low, source + middle, high - middle, target + low, compare);
+        }
+    }
+    catch (...)
+    {
+        const std::size_t next = std::min(low + 2 * width, n);
+        std::move(source + next, source + n, target + next);
+        throw;
+    }
+}
+
+// Stable sort of n items on one thread: insertion sorted runs, then merge
+// rounds bouncing between items and scratch, which holds n live objects.
+// The items end up in items, even if compare throws.
+template <typename Type, typename Compare>
+void sequentialStableSort(Type* items, Type* scratch, std::size_t n, Compare& compare)
+{
+    for (std::size_t from = 0; from < n; from += smallRun)
+        insertionSort(items + from, std::min(smallRun, n - from), compare);
+    Type* source = items;
+    Type* target = scratch;
+    try
+    {
+        for (std::size_t width = smallRun; width < n; width *= 2)
+        {
+            mergeRound(source, target, n, width, compare);
+            std::swap(source, target);
+        }
+    }
+    catch (...)
+    {
+        if (target != items) std::move(target, target + n, items);
+        throw;
+    }
+    if (source != items) std::move(source, source + n, items);
+}
+
+template <typename Type>
+class MergeBuffer
+{
+private:
+  Type* items;
+  std::size_t n;
+
+public:
+  // starts out holding the items moved from source
+  MergeBuffer(Type* source, std::size_t count)
+    : items(allocateStorage<Type>(count)), n(0)
+  {
+      std::uninitialized_move(source, source + count, items);
+      n = count;
+  }
+
+  MergeBuffer(const MergeBuffer&) = delete;
+  MergeBuffer& operator=(const MergeBuffer&) = delete;
+
+  ~MergeBuffer()
+  {
+      destroyRange(items, n);
+      deallocateStorage(items);
+  }
+
+  Type* data() const
+  {
+    return items;
+  }
+};
+
+}
+
+// Stable sort of n contiguous items. Runs of about n / threads items are
+// sorted in parallel, then merged pairwise, each merge split into pieces by
+// merge path so that the last rounds keep every thread busy too. Small inputs
+// and single-thread pools are sorted on the calling thread.
+//
+// If compare throws, the items are left in an unspecified order, but every
+// one of them is still there: each merge moves what it has not consumed yet
+// to its output, so at any time all items sit in one of the two arrays.
+template <typename Type, typename Compare>
+void parallelStableSort(Type* items, std::size_t n, Compare compare, ThreadPool& pool)
+{
+    if (n <= sorting::smallRun)
+    {
+        sorting::insertionSort(items, n, compare);
+        return;
+    }
+
+    sorting::MergeBuffer<Type> buffer(items, n);
+    Type* source = buffer.data();
+    Type* target = items;
+    Type* holder = source; //the array holding every item, even after a throw
+    try
+    {
+        const std::size_t threads = pool.getThreadCount();
+        if (threads == 1 || n < 2 * sorting::grain)
+            sorting::sequentialStableSort(source, target, n, compare);
+        else
+        {
+            const std::size_t runs = std::min(threads, n / sorting::grain);
+            const std::size_t runSize = (n + runs - 1) / runs;
+            pool.forEachIndex(runs, [&](std::size_t run) {
+                const std::size_t from = run * runSize, to = std::min(from + runSize, n);
+                sorting::sequentialStableSort(source + from, target + from, to - from, compare);
+            });
+            for (std::size_t width = runSize;; width *= 2)
+            {
+                const std::size_t pairs = (n + 2 * width - 1) / (2 * width);
+                holder = target;
+                pool.forEachIndex(pairs, [&](std::size_t pair) {
+                    const std::size_t low = pair * 2 * width;
+                    const std::size_t middle = std::min(low + width, n), high = std::min(low + 2 * width, n);
+                    sorting::mergeRuns(source + low, middle - low, source + middle, high - middle, target + low,
+                                       compare, pool);
+                });
+                if (2 * width >= n) break;
+                std::swap(source, target);
+            }
+        }
+    }
+    catch (...)
+    {
+        if (holder != items) std::move(holder, holder + n, items);
+        throw;
+    }
+    if (holder != items) std::move(holder, holder + n, items);
+}
+
+// Stable sort of a whole Vector, in parallel when it is large.
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth,
+          typename Compare = std::less<Type>>
+void sort(Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>& items, Compare compare = Compare(),
+          ThreadPool& pool = ThreadPool::shared())
+{
+    parallelStableSort(items.data(), items.getSize(), compare, pool);
+}
+
+}
+#endif // AISDI_LINEAR_SORTING_H
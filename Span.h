@@ -0,0 +1,84 @@
+#ifndef AISDI_LINEAR_SPAN_H
+#define AISDI_LINEAR_SPAN_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace aisdi
+{
+
+// Non-owning view of a contiguous run of elements, in the spirit of
+// std::span. Its iterators are plain pointers, so standard algorithms pick
+// their pointer specializations (memmove for copies of trivial types, etc.).
+template <typename Type>
+class Span
+{
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = typename std::remove_cv<Type>::type;
+  using pointer = Type*;
+  using reference = Type&;
+  using iterator = Type*;
+
+private:
+  pointer items;
+  size_type n;
+
+public:
+  Span()
+    : items(nullptr), n(0)
+  {}
+
+  Span(pointer data, size_type size)
+    : items(data), n(size)
+  {}
+
+  // Span<Type> converts to Span<const Type>
+  template <typename Other, typename = typename std::enable_if<
+              std::is_convertible<Other(*)[], Type(*)[]>::value>::type>
+  Span(const Span<Other>& other)
+    : items(other.data()), n(other.getSize())
+  {}
+
+  pointer data() const
+  {
+    return items;
+  }
+
+  size_type getSize() const
+  {
+    return n;
+  }
+
+  bool isEmpty() const
+  {
+    return n == 0;
+  }
+
+  reference operator[](size_type i) const
+  {
+    return items[i];
+  }
+
+  // elements [offset, offset + count) of this span
+  Span subspan(size_type offset, size_type count) const
+  {
+    if (offset > n || count > n - offset) throw std::out_of_range("subspan exceeds the span");
+    return Span(items + offset, count);
+  }
+
+  iterator begin() const
+  {
+    return items;
+  }
+
+  iterator end() const
+  {
+    return items + n;
+  }
+};
+
+}
+#endif // AISDI_LINEAR_SPAN_H
@@ -0,0 +1,215 @@
+#ifndef AISDI_LINEAR_SPSCRING_H
+#define AISDI_LINEAR_SPSCRING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include "Memory.h"
+#include "Span.h"
+
+namespace aisdi
+{
+
+// Fixed capacity ring for exactly one producer thread and one consumer
+// thread, lock-free and wait-free. Storage is taken the way Vector takes it
+// (allocateStorage, items constructed in place), and as in RingVector the
+// capacity is a power of two, so the slot of position i is i masked.
+//
+// head and tail count pushes and pops since construction and never wrap in
+// practice. Each one sits in its own cache line together with the owner's
+// cached copy of the other index, so the two threads only share a line when
+// the cached copy runs out: the producer rereads head only when the ring
+// looks too full for what it pushes, the consumer rereads tail only when too
+// few items look ready.
+template <typename Type>
+class SpscRing
+{
+public:
+  using size_type = std::size_t;
+  using value_type = Type;
+  using reference = Type&;
+  using const_reference = const Type&;
+
+private:
+  struct alignas(cacheLineSize) Producer
+  {
+    std::atomic<size_type> tail{0}; // next position to write
+    size_type cachedHead = 0;
+  };
+
+  struct alignas(cacheLineSize) Consumer
+  {
+    std::atomic<size_type> head{0}; // next position to read
+    size_type cachedTail = 0;
+  };
+
+  Type* const buffer;
+  const size_type mask;
+  Producer producer;
+  Consumer consumer;
+
+  static size_type roundedCapacity(size_type capacity);
+  size_type freeSlots(size_type tail, size_type wanted);
+  size_type readySlots(size_type head, size_type wanted);
+
+public:
+  explicit SpscRing(size_type capacity); //rounded up to a power of two
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+  ~SpscRing();
+
+  // producer side
+  bool tryPush(const Type& item);
+  bool tryPush(Type&& item);
+  template <typename... Args>
+  bool tryEmplace(Args&&... args);
+  size_type pushN(Span<const Type> items); //copies as many as fit, returns how many
+
+  // consumer side
+  bool tryPop(Type& item);
+  size_type popN(Span<Type> items); //moves out as many as are ready, returns how many
+
+  // exact only on a thread that owns one of the ends, and only for its end
+  size_type getSize() const
+  {
+    return producer.tail.load(std::memory_order_acquire) - consumer.head.load(std::memory_order_acquire);
+  }
+
+  bool isEmpty() const
+  {
+    return getSize() == 0;
+  }
+
+  size_type capacity() const
+  {
+    return mask + 1;
+  }
+};
+
+template <typename Type>
+typename SpscRing<Type>::size_type SpscRing<Type> :: roundedCapacity(size_type capacity)
+{
+    size_type rounded = 1;
+    while (rounded < capacity) rounded *= 2;
+    return rounded;
+}
+
+template <typename Type>
+SpscRing<Type> :: SpscRing(size_type capacity)
+    : buffer(allocateStorage<Type>(roundedCapacity(capacity))), mask(roundedCapacity(capacity) - 1)
+{}
+
+template <typename Type>
+SpscRing<Type> :: ~SpscRing()
+{
+    const size_type tail = producer.tail.load(std::memory_order_relaxed);
+    for (size_type i = consumer.head.load(std::memory_order_relaxed); i != tail; i++)
+        buffer[i & mask].~Type();
+    deallocateStorage(buffer);
+}
+
+template <typename Type>
+typename SpscRing<Type>::size_type SpscRing<Type> :: freeSlots(size_type tail, size_type wanted)
+{
+    size_type free = capacity() - (tail - producer.cachedHead);
+    if (free < wanted)
+    {
+        producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+        free = capacity() - (tail - producer.cachedHead);
+    }
+    return free;
+}
+
+template <typename Type>
+typename SpscRing<Type>::size_type SpscRing<Type> :: readySlots(size_type head, size_type wanted)
+{
+    size_type ready = consumer.cachedTail - head;
+    if (ready < wanted)
+    {
+        consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+        ready = consumer.cachedTail - head;
+    }
+    return ready;
+}
+
+template <typename Type>
+template <typename... Args>
+bool SpscRing<Type> :: tryEmplace(Args&&... args)
+{
+    const size_type tail = producer.tail.load(std::memory_order_relaxed);
+    if (freeSlots(tail, 1) == 0) return false;
+    new (&buffer[tail & mask]) Type(std::forward<Args>(args)...);
+    producer.tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename Type>
+bool SpscRing<Type> :: tryPush(const Type& item)
+{
+    return tryEmplace(item);
+}
+
+template <typename Type>
+bool SpscRing<Type> :: tryPush(Type&& item)
+{
+    return tryEmplace(std::move(item));
+}
+
+// The free slots are at most two contiguous runs, up to the end of the
+// buffer and then from its start; each is filled with one uninitialized_copy,
+// a memmove for trivially copyable types.
+template <typename Type>
+typename SpscRing<Type>::size_type SpscRing<Type> :: pushN(Span<const Type> items)
+{
+    const size_type tail = producer.tail.load(std::memory_order_relaxed);
+    size_type count = std::min(items.getSize(), freeSlots(tail, items.getSize()));
+    if (count == 0) return 0;
+    const size_type start = tail & mask;
+    const size_type firstRun = std::min(count, capacity() - start);
+    std::uninitialized_copy(items.data(), items.data() + firstRun, buffer + start);
+    try
+    {
+        std::uninitialized_copy(items.data() + firstRun, items.data() + count, buffer);
+    }
+    catch (...)
+    {
+        destroyRange(buffer + start, firstRun);
+        throw;
+    }
+    producer.tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+template <typename Type>
+bool SpscRing<Type> :: tryPop(Type& item)
+{
+    const size_type head = consumer.head.load(std::memory_order_relaxed);
+    if (readySlots(head, 1) == 0) return false;
+    Type& slot = buffer[head & mask];
+    item = std::move(slot);
+    slot.~Type();
+    consumer.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename Type>
+typename SpscRing<Type>::size_type SpscRing<Type> :: popN(Span<Type> items)
+{
+    const size_type head = consumer.head.load(std::memory_order_relaxed);
+    size_type count = std::min(items.getSize(), readySlots(head, items.getSize()));
+    if (count == 0) return 0;
+    const size_type start = head & mask;
+    const size_type firstRun = std::min(count, capacity() - start);
+    std::move(buffer + start, buffer + start + firstRun, items.data());
+    std::move(buffer, buffer + (count - firstRun), items.data() + firstRun);
+    destroyRange(buffer + start, firstRun);
+    destroyRange(buffer, count - firstRun);
+    consumer.head.store(head + count, std::memory_order_release);
+    return count;
+}
+
+}
+#endif // AISDI_LINEAR_SPSCRING_H
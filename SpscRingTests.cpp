@@ -0,0 +1,153 @@
+#include <SpscRing.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+// The two-thread test is meant to be run under ThreadSanitizer as well
+// (-fsanitize=thread), which checks the acquire/release pairs on head and tail.
+
+BOOST_AUTO_TEST_SUITE(SpscRingTests)
+
+BOOST_AUTO_TEST_CASE(GivenCapacity_WhenCreatingRing_ThenItIsRoundedUpToPowerOfTwo)
+{
+  aisdi::SpscRing<int> ring(5);
+  aisdi::SpscRing<int> exact(8);
+
+  BOOST_CHECK_EQUAL(ring.capacity(), 8);
+  BOOST_CHECK_EQUAL(exact.capacity(), 8);
+  BOOST_CHECK(ring.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(GivenEmptyRing_WhenPopping_ThenNothingIsReturned)
+{
+  aisdi::SpscRing<int> ring(4);
+  int item = 7;
+  int items[3] = { 7, 7, 7 };
+
+  BOOST_CHECK(!ring.tryPop(item));
+  BOOST_CHECK_EQUAL(item, 7);
+  BOOST_CHECK_EQUAL(ring.popN(aisdi::Span<int>(items, 3)), 0);
+  BOOST_CHECK_EQUAL(items[0], 7);
+}
+
+BOOST_AUTO_TEST_CASE(GivenFullRing_WhenPushing_ThenNothingMoreFits)
+{
+  aisdi::SpscRing<int> ring(4);
+  const int items[2] = { 5, 6 };
+
+  for (int i = 0; i < 4; ++i) BOOST_CHECK(ring.tryPush(i));
+  BOOST_CHECK(!ring.tryPush(4));
+  BOOST_CHECK(!ring.tryEmplace(4));
+  BOOST_CHECK_EQUAL(ring.pushN(aisdi::Span<const int>(items, 2)), 0);
+  BOOST_CHECK_EQUAL(ring.getSize(), 4);
+
+  int item;
+  BOOST_CHECK(ring.tryPop(item));
+  BOOST_CHECK_EQUAL(item, 0);
+  BOOST_CHECK_EQUAL(ring.pushN(aisdi::Span<const int>(items, 2)), 1);
+  BOOST_CHECK_EQUAL(ring.getSize(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(GivenRing_WhenPushingAndPoppingOneByOne_ThenItemsComeOutInOrder)
+{
+  aisdi::SpscRing<std::string> ring(2);
+  std::string b = "b";
+  std::string item;
+
+  BOOST_CHECK(ring.tryPush("a"));
+  BOOST_CHECK(ring.tryPush(b));
+  BOOST_CHECK(ring.tryPop(item));
+  BOOST_CHECK_EQUAL(item, "a");
+  BOOST_CHECK(ring.tryEmplace(2, 'c'));
+  BOOST_CHECK(ring.tryPop(item));
+  BOOST_CHECK_EQUAL(item, "b");
+  BOOST_CHECK(ring.tryPop(item));
+  BOOST_CHECK_EQUAL(item, "cc");
+  BOOST_CHECK(ring.isEmpty());
+}
+
+// Every start offset makes pushN and popN split their run at the end of the
+// buffer at another place.
+BOOST_AUTO_TEST_CASE(GivenRingAtEveryOffset_WhenPushingAndPoppingRuns_ThenRunsWrapAround)
+{
+  for (int offset = 0; offset < 8; ++offset)
+  {
+    aisdi::SpscRing<std::string> ring(8);
+    std::string item;
+    for (int i = 0; i < offset; ++i)
+    {
+      ring.tryPush("x");
+      ring.tryPop(item);
+    }
+
+    const std::vector<std::string> in = { "0", "1", "2", "3", "4", "5", "6" };
+    BOOST_CHECK_EQUAL(ring.pushN(aisdi::Span<const std::string>(in.data(), in.size())), 7);
+    std::vector<std::string> out(7);
+    BOOST_CHECK_EQUAL(ring.popN(aisdi::Span<std::string>(out.data(), 3)), 3);
+    BOOST_CHECK_EQUAL(ring.popN(aisdi::Span<std::string>(out.data() + 3, 10)), 4);
+
+    BOOST_CHECK(out == in);
+    BOOST_CHECK(ring.isEmpty());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(GivenRingDestroyedWithWrappedItems_WhenDestroyed_ThenItemsAreReleased)
+{
+  auto counter = std::make_shared<int>(0);
+  {
+    aisdi::SpscRing<std::shared_ptr<int>> ring(4);
+    std::shared_ptr<int> item;
+    for (int i = 0; i < 3; ++i) ring.tryPush(counter);
+    for (int i = 0; i < 3; ++i) ring.tryPop(item);
+    item.reset();
+    for (int i = 0; i < 3; ++i) ring.tryPush(counter); // slots 3, 0 and 1
+    BOOST_CHECK_EQUAL(counter.use_count(), 4);
+  }
+  BOOST_CHECK_EQUAL(counter.use_count(), 1);
+}
+
+// The producer pushes an increasing sequence, in runs of varying length so
+// that the runs wrap at every place; the consumer has to see it whole and
+// in order.
+BOOST_AUTO_TEST_CASE(GivenProducerAndConsumerThreads_WhenRunningConcurrently_ThenItemsArriveInOrder)
+{
+  const std::uint64_t count = 200000;
+  aisdi::SpscRing<std::uint64_t> ring(64);
+  bool ordered = true;
+  std::uint64_t received = 0;
+
+  std::thread consumer([&] {
+    std::uint64_t items[37];
+    while (received < count)
+    {
+      const std::size_t got = ring.popN(aisdi::Span<std::uint64_t>(items, 1 + received % 37));
+      for (std::size_t i = 0; i < got; ++i)
+        if (items[i] != received++) ordered = false;
+      if (got == 0) std::this_thread::yield();
+    }
+  });
+
+  std::uint64_t items[29];
+  for (std::uint64_t next = 0; next < count;)
+  {
+    const std::size_t run = static_cast<std::size_t>(std::min<std::uint64_t>(1 + next % 29, count - next));
+    for (std::size_t i = 0; i < run; ++i) items[i] = next + i;
+    const std::size_t pushed = ring.pushN(aisdi::Span<const std::uint64_t>(items, run));
+    next += pushed;
+    if (pushed == 0) std::this_thread::yield();
+  }
+  consumer.join();
+
+  BOOST_CHECK(ordered);
+  BOOST_CHECK_EQUAL(received, count);
+  BOOST_CHECK(ring.isEmpty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
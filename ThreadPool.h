@@ -0,0 +1,161 @@
+#ifndef AISDI_LINEAR_THREADPOOL_H
+#define AISDI_LINEAR_THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aisdi
+{
+
+// Fixed set of worker threads for fork-join work. forEachIndex hands task
+// indices out to the workers and to the calling thread alike, and returns
+// once every index is done, so it may be nested inside another task without
+// deadlocking even when all workers are busy.
+class ThreadPool
+{
+public:
+  using size_type = std::size_t;
+
+private:
+  struct Batch
+  {
+    std::function<void(size_type)> task;
+    size_type count;
+    std::atomic<size_type> next{0};
+    std::atomic<size_type> finished{0};
+    std::mutex mutex;
+    std::condition_variable allFinished;
+    std::exception_ptr failure;
+  };
+
+  std::vector<std::thread> workers;
+  std::deque<std::shared_ptr<Batch>> queue; //one entry per helper wanted
+  std::mutex mutex;
+  std::condition_variable workAvailable;
+  bool stopping;
+
+  void work();
+  static void runIndices(Batch& batch);
+
+public:
+  // threads counts the calling thread, so ThreadPool(1) starts no workers
+  explicit ThreadPool(size_type threads = std::thread::hardware_concurrency());
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  // how many threads, the caller included, share the work
+  size_type getThreadCount() const
+  {
+    return workers.size() + 1;
+  }
+
+  // Runs task(0) .. task(count - 1) in parallel and waits for all of them.
+  // The first exception thrown by a task is rethrown here, after the others
+  // finished.
+  template <typename Task>
+  void forEachIndex(size_type count, Task task);
+
+  static ThreadPool& shared(); //sized to the hardware, started on first use
+};
+
+inline ThreadPool :: ThreadPool(size_type threads)
+    : stopping(false)
+{
+    for (size_type i = 1; i < threads; i++)
+        workers.emplace_back([this] { work(); });
+}
+
+inline ThreadPool :: ~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+inline ThreadPool& ThreadPool :: shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+inline void ThreadPool :: runIndices(Batch& batch)
+{
+    size_type done = 0;
+    for (size_type i = batch.next++; i < batch.count; i = batch.next++)
+    {
+        try
+        {
+            batch.task(i);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(batch.mutex);
+            if (!batch.failure) batch.failure = std::current_exception();
+        }
+        done++;
+    }
+    if (done != 0 && batch.finished.fetch_add(done) + done == batch.count)
+    {
+        std::lock_guard<std::mutex> lock(batch.mutex);
+        batch.allFinished.notify_all();
+    }
+}
+
+// A helper that gets to a batch late finds no index left and drops it; the
+// shared_ptr keeps the batch alive until then.
+inline void ThreadPool :: work()
+{
+    for (;;)
+    {
+        std::shared_ptr<Batch> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+            batch = std::move(queue.front());
+            queue.pop_front();
+        }
+        runIndices(*batch);
+    }
+}
+
+template <typename Task>
+void ThreadPool :: forEachIndex(size_type count, Task task)
+{
+    if (count == 0) return;
+    auto batch = std::make_shared<Batch>();
+    batch->task = std::move(task);
+    batch->count = count;
+
+    const size_type helpers = std::min(workers.size(), count - 1);
+    if (helpers != 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_type i = 0; i < helpers; i++) queue.push_back(batch);
+        }
+        if (helpers == 1) workAvailable.notify_one();
+        else workAvailable.notify_all();
+    }
+
+    runIndices(*batch);
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->allFinished.wait(lock, [&] { return batch->finished.load() == count; });
+    if (batch->failure) std::rethrow_exception(batch->failure);
+}
+
+}
+#endif // AISDI_LINEAR_THREADPOOL_H
@@ -0,0 +1,625 @@
+#ifndef AISDI_LINEAR_UNROLLEDLINKEDLIST_H
+#define AISDI_LINEAR_UNROLLEDLINKEDLIST_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <new>
+#include <utility>
+#include "NodePool.h"
+
+namespace aisdi
+{
+
+// Doubly linked list of blocks, each holding up to NodeCapacity elements.
+// A full block is split in half on insert, and a block is merged with its
+// successor after an erase whenever both fit into one.
+template <typename Type, std::size_t NodeCapacity = 16>
+class UnrolledLinkedList
+{
+  static_assert(NodeCapacity >= 2, "a block has to hold at least two elements");
+
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+private:
+  class Block
+  {
+    public:
+      Block *next;
+      Block *prev;
+      size_type count;
+      alignas(Type) unsigned char storage[NodeCapacity * sizeof(Type)];
+
+      pointer items()
+      {
+        return reinterpret_cast<pointer>(storage);
+      }
+  };
+
+  Block *first;
+  Block *last;
+  size_type n;
+  NodePool<Block> allocator;
+
+  Block* createBlock();
+  void destroyBlock(Block* block);
+  void linkAfter(Block* block, Block* position);
+  void unlink(Block* block);
+  void moveItems(Block* to, Block* from, size_type fromIndex);
+  ConstIterator removeAt(Block* block, size_type index);
+  void clear();
+
+public:
+  UnrolledLinkedList();
+  UnrolledLinkedList(std::initializer_list<Type> l);
+  UnrolledLinkedList(const UnrolledLinkedList& other);
+  UnrolledLinkedList(UnrolledLinkedList&& other);
+  ~UnrolledLinkedList();
+
+  UnrolledLinkedList& operator=(const UnrolledLinkedList& other);
+  UnrolledLinkedList& operator=(UnrolledLinkedList&& other);
+
+  bool isEmpty() const;
+  size_type getSize() const;
+  size_type getNodeCount() const;
+
+  void append(const Type& item);
+  void prepend(const Type& item);
+  void insert(const const_iterator& insertPosition, const Type& item);
+  Type popFirst();
+  Type popLast();
+  void erase(const const_iterator& possition);
+  void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded);
+
+  iterator begin()
+  {
+    return Iterator(ConstIterator(this, first, 0));
+  }
+
+  iterator end()
+  {
+    return Iterator(ConstIterator(this, nullptr, 0));
+  }
+
+  const_iterator cbegin() const
+  {
+    return ConstIterator(this, first, 0);
+  }
+
+  const_iterator cend() const
+  {
+    return ConstIterator(this, nullptr, 0);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+};
+
+template <typename Type, std::size_t NodeCapacity>
+class UnrolledLinkedList<Type, NodeCapacity>::ConstIterator
+{
+public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename UnrolledLinkedList::value_type;
+  using difference_type = typename UnrolledLinkedList::difference_type;
+  using pointer = typename UnrolledLinkedList::const_pointer;
+  using reference = typename UnrolledLinkedList::const_reference;
+
+private:
+  const UnrolledLinkedList* mylist;
+  Block* block; // nullptr for end()
+  size_type index;
+
+public:
+  explicit ConstIterator() {}
+
+  ConstIterator(const UnrolledLinkedList* l, Block* b, size_type i)
+  {
+    mylist = l;
+    block = b;
+    index = i;
+  }
+
+  Block* GetBlock() const
+  {
+    return block;
+  }
+
+  size_type GetIndex() const
+  {
+    return index;
+  }
+
+  reference operator*() const
+  {
+    if (block == nullptr) throw std::out_of_range("there is no such item");
+    return block->items()[index];
+  }
+
+  ConstIterator& operator++()
+  {
+    if (block == nullptr) throw std::out_of_range("you cannot increase iterator");
+    if (++index == block->count)
+    {
+      block = block->next;
+      index = 0;
+    }
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp(*this);
+    operator++();
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    if (block == mylist->first && index == 0) throw std::out_of_range("you cannot decrease iterator");
+    if (block == nullptr)
+    {
+      block = mylist->last;
+      index = block->count - 1;
+    }
+    else if (index == 0)
+    {
+      block = block->prev;
+      index = block->count - 1;
+    }
+    else index--;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp(*this);
+    operator--();
+    return tmp;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    ConstIterator tmp(*this);
+    // whole blocks are skipped without visiting their elements
+    while (d > 0)
+    {
+      if (tmp.block == nullptr) throw std::out_of_range("you cannot increase iterator");
+      size_type left = tmp.block->count - tmp.index;
+      if (static_cast<size_type>(d) < left)
+      {
+        tmp.index += d;
+        break;
+      }
+      d -= left;
+      tmp.block = tmp.block->next;
+      tmp.index = 0;
+    }
+    return tmp;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    ConstIterator tmp(*this);
+    while (d > 0)
+    {
+      if (tmp.index == 0)
+      {
+        if (tmp.block == mylist->first) throw std::out_of_range("you cannot decrease iterator");
+        tmp.block = tmp.block == nullptr ? mylist->last : tmp.block->prev;
+        tmp.index = tmp.block->count;
+      }
+      size_type step = static_cast<size_type>(d) < tmp.index ? d : tmp.index;
+      tmp.index -= step;
+      d -= step;
+    }
+    return tmp;
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return mylist == other.mylist && block == other.block && index == other.index;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+template <typename Type, std::size_t NodeCapacity>
+class UnrolledLinkedList<Type, NodeCapacity>::Iterator : public UnrolledLinkedList<Type, NodeCapacity>::ConstIterator
+{
+public:
+  using pointer = typename UnrolledLinkedList::pointer;
+  using reference = typename UnrolledLinkedList::reference;
+
+  explicit Iterator() {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  reference operator*() const
+  {
+    // ugly cast, yet reduces code duplication.
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+};
+
+template <class value_type, std::size_t NodeCapacity>
+typename UnrolledLinkedList <value_type, NodeCapacity> :: Block*
+UnrolledLinkedList <value_type, NodeCapacity> :: createBlock()
+{
+    Block* block = new (allocator.allocate()) Block;
+    block->next = nullptr;
+    block->prev = nullptr;
+    block->count = 0;
+    return block;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+void UnrolledLinkedList <value_type, NodeCapacity> :: destroyBlock(Block* block)
+{
+    pointer items = block->items();
+    for (size_type i = 0; i < block->count; i++)
+        items[i].~value_type();
+    block->~Block();
+    allocator.deallocate(block);
+}
+
+// links block right after position, or at the front when position is nullptr
+template <class value_type, std::size_t NodeCapacity>
+void UnrolledLinkedList <value_type, NodeCapacity> :: linkAfter(Block* block, Block* position)
+{
+    block->prev = position;
+    block->next = position == nullptr ? first : position->next;
+    if (block->next != nullptr) block->next->prev = block;
+    else last = block;
+    if (position != nullptr) position->next = block;
+    else first = block;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+void UnrolledLinkedList <value_type, NodeCapacity> :: unlink(Block* block)
+{
+    if (block->prev != nullptr) block->prev->next = block->next;
+    else first = block->next;
+    if (block->next != nullptr) block->next->prev = block->prev;
+    else last = block->prev;
+}
+
+// moves items [fromIndex, from->count) to the back of block to. Items whose
+// move may throw are copied instead, and the sources are only destroyed once
+// all of them are across, so on a throw both blocks are left as they were.
+template <class value_type, std::size_t NodeCapacity>
+void UnrolledLinkedList <value_type, NodeCapacity> :: moveItems(Block* to, Block* from, size_type fromIndex)
+{
+    pointer src = from->items();
+    pointer dst = to->items();
+    const size_type toCount = to->count;
+    try
+    {
+        for (size_type i = fromIndex; i < from->count; i++)
+        {
+            new (&dst[to->count]) value_type(std::move_if_noexcept(src[i]));
+            to->count++;
+        }
+    }
+    catch (...)
+    {
+        for (size_type i = toCount; i < to->count; i++)
+            dst[i].~value_type();
+        to->count = toCount;
+        throw;
+    }
+    for (size_type i = fromIndex; i < from->count; i++)
+        src[i].~value_type();
+    from->count = fromIndex;
+}
+
+// removes one element and returns the position of the element that followed it
+template <class value_type, std::size_t NodeCapacity>
+typename UnrolledLinkedList <value_type, NodeCapacity> :: ConstIterator
+UnrolledLinkedList <value_type, NodeCapacity> :: removeAt(Block* block, size_type index)
+{
+    pointer items = block->items();
+    for (size_type i = index + 1; i < block->count; i++)
+        items[i - 1] = std::move(items[i]);
+    items[--block->count].~value_type();
+    n--;
+
+    if (block->count == 0)
+    {
+        Block* next = block->next;
+        unlink(block);
+        destroyBlock(block);
+        return ConstIterator(this, next, 0);
+    }
+    Block* next = block->next;
+    if (next != nullptr && block->count + next->count <= NodeCapacity)
+    {
+        moveItems(block, next, 0);
+        unlink(next);
+        destroyBlock(next);
+    }
+    if (index < block->count) return ConstIterator(this, block, index);
+    return ConstIterator(this, block->next, 0);
+}
+
+template <class value_type, std::size_t NodeCapacity>
+void UnrolledLinkedList <value_type, NodeCapacity> :: clear()
+{
+    while (first != nullptr)
+    {
+        Block* tmp = first->next;
+        destroyBlock(first);
+        first = tmp;
+    }
+    last = nullptr;
+    n = 0;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+UnrolledLinkedList <value_type, NodeCapacity> :: UnrolledLinkedList()
+{
+    first = nullptr;
+    last = nullptr;
+    n = 0;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+UnrolledLinkedList <value_type, NodeCapacity> :: UnrolledLinkedList(std::initializer_list<value_type> l)
+  : UnrolledLinkedList()
+{
+    for (auto it = l.begin(); it != l.end(); it++)
+        append(*it);
+}
+
+template <class value_type, std::size_t NodeCapacity>
+UnrolledLinkedList <value_type, NodeCapacity> :: UnrolledLinkedList(const UnrolledLinkedList& other)
+  : UnrolledLinkedList()
+{
+    try
+    {
+        for (auto it = other.begin(); it != other.end(); ++it)
+            append(*it);
+    }
+    catch (...)
+    {
+        clear();
+        throw;
+    }
+}
+
+template <class value_type, std::size_t NodeCapacity>
+UnrolledLinkedList <value_type, NodeCapacity> :: UnrolledLinkedList(UnrolledLinkedList&& other)
+  : UnrolledLinkedList()
+{
+    std::swap(first, other.first);
+    std::swap(last, other.last);
+    std::swap(n, other.n);
+    allocator.swap(other.allocator);
+}
+
+template <class value_type, std::size_t NodeCapacity>
+UnrolledLinkedList <value_type, NodeCapacity> :: ~UnrolledLinkedList()
+{
+    clear();
+}
+
+template <class value_type, std::size_t NodeCapacity>
+UnrolledLinkedList <value_type, NodeCapacity>& UnrolledLinkedList <value_type, NodeCapacity> :: operator=(const UnrolledLinkedList& other)
+{
+    if (this == &other) return *this;
+    clear();
+    for (auto it = other.begin(); it != other.end(); ++it)
+        append(*it);
+    return *this;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+UnrolledLinkedList <value_type, NodeCapacity>& UnrolledLinkedList <value_type, NodeCapacity> :: operator=(UnrolledLinkedList&& other)
+{
+    if (this == &other) return *this;
+    clear();
+    std::swap(first, other.first);
+    std::swap(last, other.last);
+    std::swap(n, other.n);
+    allocator.swap(other.allocator);
+    return *this;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+bool UnrolledLinkedList <value_type, NodeCapacity> :: isEmpty() const
+{
+    return n == 0;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+size_t UnrolledLinkedList <value_type, NodeCapacity> :: getSize() const
+{
+    return n;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+size_t UnrolledLinkedList <value_type, NodeCapacity> :: getNodeCount() const
+{
+    size_type count = 0;
+    for (Block* block = first; block != nullptr; block = block->next)
+        count++;
+    return count;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+void UnrolledLinkedList <value_type, NodeCapacity> :: append(const value_type& item)
+{
+    if (last == nullptr || last->count == NodeCapacity)
+    {
+        Block* block = createBlock();
+        try
+        {
+            new (block->items()) value_type(item);
+        }
+        catch (...)
+        {
+            destroyBlock(block);
+            throw;
+        }
+        block->count = 1;
+        linkAfter(block, last);
+    }
+    else
+    {
+        new (&last->items()[last->count]) value_type(item);
+        last->count++;
+    }
+    n++;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+void UnrolledLinkedList <value_type, NodeCapacity> :: prepend(const value_type& item)
+{
+    insert(cbegin(), item);
+}
+
+template <class value_type, std::size_t NodeCapacity>
+void UnrolledLinkedList <value_type, NodeCapacity> :: insert(const const_iterator& insertPosition, const value_type& item)
+{
+    Block* block = insertPosition.GetBlock();
+    size_type index = insertPosition.GetIndex();
+    if (block == nullptr)
+    {
+        append(item);
+        return;
+    }
+
+    if (block->count == NodeCapacity)
+    {
+        Block* upper = createBlock();
+        try
+        {
+            moveItems(upper, block, NodeCapacity / 2);
+        }
+        catch (...)
+        {
+            destroyBlock(upper);
+            throw;
+        }
+        linkAfter(upper, block);
+        if (index > block->count)
+        {
+            index -= block->count;
+            block = upper;
+        }
+    }
+
+    value_type copy(item);
+    pointer items = block->items();
+    if (index == block->count)
+        new (&items[index]) value_type(std::move(copy));
+    else
+    {
+        new (&items[block->count]) value_type(std::move(items[block->count - 1]));
+        for (size_type i = block->count - 1; i > index; i--)
+            items[i] = std::move(items[i - 1]);
+        items[index] = std::move(copy);
+    }
+    block->count++;
+    n++;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+value_type UnrolledLinkedList <value_type, NodeCapacity> :: popFirst()
+{
+    if (n == 0) throw std::logic_error("list is empty");
+    value_type item = std::move(first->items()[0]);
+    removeAt(first, 0);
+    return item;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+value_type UnrolledLinkedList <value_type, NodeCapacity> :: popLast()
+{
+    if (n == 0) throw std::logic_error("list is empty");
+    value_type item = std::move(last->items()[last->count - 1]);
+    removeAt(last, last->count - 1);
+    return item;
+}
+
+template <class value_type, std::size_t NodeCapacity>
+void UnrolledLinkedList <value_type, NodeCapacity> :: erase(const const_iterator& possition)
+{
+    if (possition.GetBlock() == nullptr) throw std::out_of_range("");
+    removeAt(possition.GetBlock(), possition.GetIndex());
+}
+
+template <class value_type, std::size_t NodeCapacity>
+void UnrolledLinkedList <value_type, NodeCapacity> :: erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+{
+    // merging blocks invalidates lastExcluded, so count the run up front
+    size_type count = 0;
+    for (auto it = firstIncluded; it != lastExcluded; ++it)
+        count++;
+    ConstIterator position = firstIncluded;
+    while (count-- > 0)
+        position = removeAt(position.GetBlock(), position.GetIndex());
+}
+
+}
+#endif // AISDI_LINEAR_UNROLLEDLINKEDLIST_H
@@ -0,0 +1,243 @@
+#include <UnrolledLinkedList.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+namespace
+{
+
+// four items per block, so a few items already split and merge blocks
+template <typename T>
+using SmallBlocks = aisdi::UnrolledLinkedList<T, 4>;
+
+template <typename Collection>
+void thenCollectionContainsValues(const Collection& collection, std::initializer_list<int> expected)
+{
+  BOOST_CHECK_EQUAL(collection.getSize(), expected.size());
+  BOOST_CHECK(std::equal(collection.begin(), collection.end(), expected.begin(), expected.end()));
+}
+
+// An item whose copies start throwing after copiesLeft of them.
+struct Fragile
+{
+  static int copiesLeft;
+  static int live;
+  int value;
+
+  Fragile(int item) : value(item) { live++; }
+  Fragile(const Fragile& other) : value(other.value)
+  {
+    if (copiesLeft-- == 0) throw std::runtime_error("copy failed");
+    live++;
+  }
+  Fragile& operator=(const Fragile&) = default;
+  ~Fragile() { live--; }
+
+  bool operator==(int other) const
+  {
+    return value == other;
+  }
+};
+
+int Fragile::copiesLeft = -1;
+int Fragile::live = 0;
+
+}
+
+BOOST_AUTO_TEST_SUITE(UnrolledLinkedListTests)
+
+BOOST_AUTO_TEST_CASE(GivenEmptyList_WhenCreated_ThenItHasNoBlocks)
+{
+  SmallBlocks<int> collection;
+
+  BOOST_CHECK(collection.isEmpty());
+  BOOST_CHECK_EQUAL(collection.getNodeCount(), 0);
+  BOOST_CHECK(collection.begin() == collection.end());
+  BOOST_CHECK_THROW(collection.popFirst(), std::logic_error);
+  BOOST_CHECK_THROW(collection.popLast(), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(GivenList_WhenAppending_ThenBlocksFillUpBeforeNewOnesAreAdded)
+{
+  SmallBlocks<int> collection;
+  for (int i = 0; i < 9; ++i) collection.append(i);
+
+  BOOST_CHECK_EQUAL(collection.getNodeCount(), 3);
+  thenCollectionContainsValues(collection, { 0, 1, 2, 3, 4, 5, 6, 7, 8 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenFullBlock_WhenInsertingIntoIt_ThenItIsSplitInHalf)
+{
+  SmallBlocks<int> collection = { 1, 2, 3, 4 };
+
+  collection.insert(collection.begin() + 1, 9);
+  BOOST_CHECK_EQUAL(collection.getNodeCount(), 2);
+  thenCollectionContainsValues(collection, { 1, 9, 2, 3, 4 });
+
+  collection.insert(collection.begin() + 4, 8);
+  thenCollectionContainsValues(collection, { 1, 9, 2, 3, 8, 4 });
+  collection.prepend(0);
+  collection.insert(collection.end(), 5);
+  thenCollectionContainsValues(collection, { 0, 1, 9, 2, 3, 8, 4, 5 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenInsertsAtEveryPosition_WhenListGrows_ThenOrderIsKept)
+{
+  for (int position = 0; position <= 12; ++position)
+  {
+    SmallBlocks<std::string> collection;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 12; ++i)
+    {
+      collection.append(std::to_string(i));
+      expected.push_back(std::to_string(i));
+    }
+
+    collection.insert(collection.begin() + position, "x");
+    expected.insert(expected.begin() + position, "x");
+
+    BOOST_CHECK_EQUAL(collection.getSize(), 13);
+    BOOST_CHECK(std::equal(collection.begin(), collection.end(), expected.begin(), expected.end()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(GivenNeighbouringBlocksThatFitInOne_WhenErasing_ThenTheyAreMerged)
+{
+  SmallBlocks<int> collection = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  BOOST_CHECK_EQUAL(collection.getNodeCount(), 2);
+
+  collection.erase(collection.begin() + 5);
+  collection.erase(collection.begin());
+  collection.erase(collection.begin());
+  BOOST_CHECK_EQUAL(collection.getNodeCount(), 2);
+  collection.erase(collection.begin());
+  BOOST_CHECK_EQUAL(collection.getNodeCount(), 1);
+  thenCollectionContainsValues(collection, { 4, 5, 7, 8 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenLastItemOfBlock_WhenErasing_ThenTheBlockIsFreed)
+{
+  SmallBlocks<int> collection = { 1, 2, 3, 4, 5 };
+
+  collection.erase(collection.begin() + 4);
+  BOOST_CHECK_EQUAL(collection.getNodeCount(), 1);
+  BOOST_CHECK_EQUAL(collection.popLast(), 4);
+  BOOST_CHECK_EQUAL(collection.popFirst(), 1);
+  thenCollectionContainsValues(collection, { 2, 3 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenRange_WhenErasingAcrossBlocks_ThenOnlyTheRangeIsRemoved)
+{
+  SmallBlocks<std::string> collection;
+  for (int i = 0; i < 20; ++i) collection.append(std::to_string(i));
+
+  collection.erase(collection.begin() + 3, collection.begin() + 17);
+
+  std::vector<std::string> left(collection.begin(), collection.end());
+  BOOST_CHECK((left == std::vector<std::string>{ "0", "1", "2", "17", "18", "19" }));
+  BOOST_CHECK_LE(collection.getNodeCount(), 2);
+  collection.erase(collection.begin(), collection.end());
+  BOOST_CHECK(collection.isEmpty());
+  BOOST_CHECK_EQUAL(collection.getNodeCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(GivenFullBlock_WhenSplittingItThrows_ThenTheListIsUnchanged)
+{
+  Fragile::live = 0;
+  {
+    SmallBlocks<Fragile> collection;
+    for (int i = 1; i <= 4; ++i) collection.append(Fragile(i));
+
+    Fragile::copiesLeft = 1;
+    BOOST_CHECK_THROW(collection.insert(collection.begin() + 1, Fragile(9)), std::runtime_error);
+    Fragile::copiesLeft = -1;
+
+    BOOST_CHECK_EQUAL(collection.getNodeCount(), 1);
+    thenCollectionContainsValues(collection, { 1, 2, 3, 4 });
+    BOOST_CHECK_EQUAL(Fragile::live, 4);
+    collection.insert(collection.begin() + 1, Fragile(9));
+    thenCollectionContainsValues(collection, { 1, 9, 2, 3, 4 });
+  }
+  BOOST_CHECK_EQUAL(Fragile::live, 0);
+}
+
+BOOST_AUTO_TEST_CASE(GivenItemsInSeveralBlocks_WhenMovingIterators_ThenTheyCrossBlockBorders)
+{
+  SmallBlocks<int> collection;
+  for (int i = 0; i < 10; ++i) collection.append(i);
+
+  auto it = collection.begin();
+  for (int i = 0; i < 10; ++i, ++it) BOOST_CHECK_EQUAL(*it, i);
+  BOOST_CHECK(it == collection.end());
+  for (int i = 9; i >= 0; --i) BOOST_CHECK_EQUAL(*--it, i);
+  BOOST_CHECK(it == collection.begin());
+
+  BOOST_CHECK_EQUAL(*(collection.begin() + 7), 7);
+  BOOST_CHECK_EQUAL(*(collection.end() - 1), 9);
+  BOOST_CHECK_EQUAL(*(collection.end() - 10), 0);
+  BOOST_CHECK_EQUAL(*((collection.begin() + 9) - 6), 3);
+  BOOST_CHECK(collection.begin() + 10 == collection.end());
+}
+
+BOOST_AUTO_TEST_CASE(GivenIteratorAtAnEnd_WhenMovingPastIt_ThenExceptionIsThrown)
+{
+  SmallBlocks<int> collection = { 1, 2, 3, 4, 5 };
+
+  BOOST_CHECK_THROW(collection.end()++, std::out_of_range);
+  BOOST_CHECK_THROW(collection.begin()--, std::out_of_range);
+  BOOST_CHECK_THROW(collection.begin() + 6, std::out_of_range);
+  BOOST_CHECK_THROW(collection.end() - 6, std::out_of_range);
+  BOOST_CHECK_THROW(*collection.end(), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(GivenList_WhenWritingThroughIterator_ThenItemChanges)
+{
+  SmallBlocks<int> collection = { 1, 2, 3, 4, 5 };
+
+  *(collection.begin() + 4) = 9;
+  for (auto& item : collection) item *= 2;
+
+  thenCollectionContainsValues(collection, { 2, 4, 6, 8, 18 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenList_WhenCopyingAndMoving_ThenItemsFollow)
+{
+  SmallBlocks<std::string> collection;
+  for (int i = 0; i < 9; ++i) collection.append(std::to_string(i));
+
+  SmallBlocks<std::string> copy(collection);
+  SmallBlocks<std::string> moved(std::move(collection));
+  SmallBlocks<std::string> assigned;
+  assigned = copy;
+  copy.popFirst();
+
+  BOOST_CHECK(collection.isEmpty());
+  BOOST_CHECK_EQUAL(moved.getSize(), 9);
+  BOOST_CHECK_EQUAL(assigned.getSize(), 9);
+  BOOST_CHECK_EQUAL(*assigned.begin(), "0");
+  BOOST_CHECK_EQUAL(*copy.begin(), "1");
+  BOOST_CHECK(std::equal(moved.begin(), moved.end(), assigned.begin(), assigned.end()));
+}
+
+BOOST_AUTO_TEST_CASE(GivenListDestroyedWithItems_WhenDestroyed_ThenItemsAreReleased)
+{
+  auto counter = std::make_shared<int>(0);
+  {
+    SmallBlocks<std::shared_ptr<int>> collection;
+    for (int i = 0; i < 10; ++i) collection.append(counter);
+    collection.insert(collection.begin() + 2, counter);
+    collection.erase(collection.begin() + 5);
+    BOOST_CHECK_EQUAL(counter.use_count(), 11);
+  }
+  BOOST_CHECK_EQUAL(counter.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,16 +2,36 @@
 #define AISDI_LINEAR_VECTOR_H
 
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
-#include <cstring>
 #include <stdexcept>
-#define CAPACITY 50
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Checking.h"
+#include "Instrumentation.h"
+#include "Memory.h"
+#include "Span.h"
 
 namespace aisdi
 {
 
-template <typename Type>
-class Vector
+// Growth policy for Vector: the first append to an empty vector allocates
+// initialCapacity slots, and addMemory multiplies the capacity by factor.
+// Other policies are structs with the same two members.
+struct DefaultGrowth
+{
+  static constexpr std::size_t initialCapacity = 50;
+  static constexpr double factor = 2.0;
+};
+
+// With InlineCapacity > 0 the first InlineCapacity items are kept inside the
+// Vector object itself, and the heap is only used once it outgrows them.
+template <typename Type, class Instrumentation = NoInstrumentation, class Checking = DefaultChecking,
+          std::size_t InlineCapacity = 0, class Growth = DefaultGrowth>
+class Vector : private Instrumentation, private InlineStorage<Type, InlineCapacity>
 {
 public:
   using difference_type = std::ptrdiff_t;
@@ -28,13 +48,25 @@ public:
   using const_iterator = ConstIterator;
 
 private:
-  pointer first;
-  size_type capacity; //max vector's size
+  pointer first; //raw storage, only [0, n) is constructed
+  size_type allocated; //max vector's size before the next addMemory
   size_type n; //how many elements vector inludes
 
+  pointer allocateItems(size_type count);
+  void releaseItems(pointer p); //frees p unless it is the inline buffer
+  bool isInline() const;
+  void stealFrom(Vector& other);
+  void moveItems(pointer to, pointer from, size_type count);
+  void reallocate(size_type newCapacity);
+  size_type grownCapacity() const;
+  template <typename InputIterator>
+  void insertRange(size_type i, InputIterator firstItem, InputIterator lastItem, std::input_iterator_tag);
+  template <typename ForwardIterator>
+  void insertRange(size_type i, ForwardIterator firstItem, ForwardIterator lastItem, std::forward_iterator_tag);
+
 public:
 
-  Vector(); //creates empty vector, with defined capacity
+  Vector(); //creates empty vector, allocates nothing until it outgrows the inline capacity
   Vector(std::initializer_list<Type> l);
   Vector(const Vector& other);
   Vector(Vector&& other);
@@ -42,15 +74,41 @@ public:
 
   Vector& operator=(const Vector other);
   value_type& operator[](int i);
+  pointer data(); //contiguous storage of getSize() elements, invalidated by reallocation
+  const_pointer data() const;
+  Span<Type> asSpan();
+  Span<const Type> asSpan() const;
   bool isEmpty() const;
   size_type getSize() const;
+  size_type capacity() const;
+  void reserve(size_type newCapacity);
+  void shrinkToFit();
   void swapVectors (Vector &x, Vector &y);
-  void addMemory(); //function doubles vector's capacity
+  const Instrumentation& getInstrumentation() const
+  {
+    return *this;
+  }
+  void addMemory(); //function grows capacity by Growth::factor
   void append(const Type& item);
+  void append(Type&& item);
   void prepend(const Type& item);
+  void prepend(Type&& item);
+  template <typename... Args>
+  void emplaceAppend(Args&&... args);
+  template <typename... Args>
+  void emplacePrepend(Args&&... args);
   Type popFirst();
   Type popLast();
   void insert(const const_iterator& insertPosition, const Type& item);
+  void insert(const const_iterator& insertPosition, Type&& item);
+  template <typename... Args>
+  void emplace(const const_iterator& position, Args&&... args);
+  template <typename InputIterator>
+  void appendRange(InputIterator firstItem, InputIterator lastItem);
+  pointer appendUninitialized(size_type count); //trivially copyable items only, their bytes are left to the caller
+  template <typename InputIterator>
+  void insert(const const_iterator& insertPosition, InputIterator firstItem, InputIterator lastItem);
+  void insert(const const_iterator& insertPosition, std::initializer_list<Type> l);
   void erase(const const_iterator& position);
   void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded);
 
@@ -87,106 +145,163 @@ public:
   }
 };
 
-template <typename Type>
-class Vector<Type>::ConstIterator
+// Vector that holds up to InlineCapacity items without touching the heap.
+template <typename Type, std::size_t InlineCapacity = 16>
+using SmallVector = Vector<Type, NoInstrumentation, DefaultChecking, InlineCapacity>;
+
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+class Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>::ConstIterator
 {
 public:
-  using iterator_category = std::bidirectional_iterator_tag;
+  using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+  using iterator_concept = std::contiguous_iterator_tag;
+#endif
   using value_type = typename Vector::value_type;
   using difference_type = typename Vector::difference_type;
   using pointer = typename Vector::const_pointer;
   using reference = typename Vector::const_reference;
 private:
-  const Vector<value_type> *p;
-  int index;
+  const Vector *p; //owner, only consulted by the checks and instrumentation
+  typename Vector::pointer item; //points straight into the storage, invalidated by reallocation
 public:
   explicit ConstIterator() {}
 
-  ConstIterator(const Vector<value_type> *vec, int i)
+  ConstIterator(const Vector *vec, difference_type i)
   {
     p = vec;
-    if (i > (vec->n +1) || i<0) throw std::out_of_range ("");
-    index = i;
+    if (Checking::enabled && (i > static_cast<difference_type>(vec->n) || i<0)) throw std::out_of_range ("");
+    item = vec->first + i;
   }
 
   ConstIterator(const ConstIterator &other)
   {
     p = other.p;
-    index = other.index;
+    item = other.item;
   }
 
+  ConstIterator& operator=(const ConstIterator &other) = default;
+
   reference operator*() const
   {
-    if (index >= p->n || index<0) throw std::out_of_range("there is no element with this index");
-    return p->first[index];
+    if (Checking::enabled && (item < p->first || item >= p->first + p->n)) throw std::out_of_range("there is no element with this index");
+    return *item;
   }
 
-  int getIndex() const
+  pointer operator->() const
   {
-    return index;
+    return std::addressof(operator*());
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return *(*this + d);
+  }
+
+  difference_type getIndex() const
+  {
+    return item - p->first;
   }
 
   ConstIterator& operator++()
   {
-     if (index >= p->n) throw std::out_of_range("you cannot increase iterator");
-     index++;
+     if (Checking::enabled && item >= p->first + p->n) throw std::out_of_range("you cannot increase iterator");
+     p->countIteratorSteps(1);
+     item++;
      return *this;
   }
 
   ConstIterator operator++(int)
   {
-    if (index >= p->n) throw std::out_of_range("you cannot increase iterator");
     ConstIterator tmp(*this);
-    index++;
+    operator++();
     return tmp;
   }
 
   ConstIterator& operator--()
   {
-     if (index == 0) throw std::out_of_range("iterator cannot be smaller than 0");
-     index--;
+     if (Checking::enabled && item <= p->first) throw std::out_of_range("iterator cannot be smaller than 0");
+     p->countIteratorSteps(1);
+     item--;
      return *this;
   }
 
   ConstIterator operator--(int)
   {
-    if (index == 0) throw std::out_of_range("iterator cannot be smaller than 0");
     ConstIterator tmp(*this);
-    index--;
+    operator--();
     return tmp;
   }
 
+  ConstIterator& operator+=(difference_type d)
+  {
+    if (Checking::enabled && d > (p->first + p->n) - item) throw std::out_of_range("you cannot incerease iterator");
+    if (Checking::enabled && d < p->first - item) throw std::out_of_range("iterator cannot be smaller than 0");
+    p->countIteratorSteps(1);
+    item += d;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
   ConstIterator operator+(difference_type d) const
   {
-    if (index > (p->n-d)) throw std::out_of_range("you cannot incerease iterator");
     ConstIterator tmp(*this);
-    tmp.index += d;
-    return tmp;
+    return tmp += d;
+  }
+
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
   }
 
   ConstIterator operator-(difference_type d) const
   {
-    if (index < d) throw std::out_of_range("iterator cannot be smaller than 0");
     ConstIterator tmp(*this);
-    tmp.index = tmp.index -d;
-    return tmp;
+    return tmp -= d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return item - other.item;
   }
 
   bool operator==(const ConstIterator& other) const
   {
-    if (p == other.p && index == other.index) return true;
-    return false;
+    return p == other.p && item == other.item;
   }
 
   bool operator!=(const ConstIterator& other) const
   {
-    if (p == other.p && index == other.index) return false;
-    return true;
+    return !(*this == other);
+  }
+
+  bool operator<(const ConstIterator& other) const
+  {
+    return item < other.item;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
+
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
   }
 };
 
-template <typename Type>
-class Vector<Type>::Iterator : public Vector<Type>::ConstIterator
+template <typename Type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+class Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>::Iterator : public Vector<Type, Instrumentation, Checking, InlineCapacity, Growth>::ConstIterator
 {
   public:
   using pointer = typename Vector::pointer;
@@ -225,173 +340,474 @@ class Vector<Type>::Iterator : public Vector<Type>::ConstIterator
     return result;
   }
 
+  Iterator& operator+=(difference_type d)
+  {
+    ConstIterator::operator+=(d);
+    return *this;
+  }
+
+  Iterator& operator-=(difference_type d)
+  {
+    ConstIterator::operator-=(d);
+    return *this;
+  }
+
   Iterator operator+(difference_type d) const
   {
     return ConstIterator::operator+(d);
   }
 
+  friend Iterator operator+(difference_type d, const Iterator& it)
+  {
+    return it + d;
+  }
+
   Iterator operator-(difference_type d) const
   {
     return ConstIterator::operator-(d);
   }
 
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return ConstIterator::operator-(other);
+  }
+
   reference operator*() const
   {
     // ugly cast, yet reduces code duplication.
     return const_cast<reference>(ConstIterator::operator*());
   }
+
+  pointer operator->() const
+  {
+    return std::addressof(operator*());
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return *(*this + d);
+  }
 };
 
-template <class value_type>
-Vector <value_type> :: Vector()
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+Vector <value_type, Instrumentation, Checking, InlineCapacity, Growth> :: Vector()
 {
-    first = new value_type [CAPACITY]; // CAPACITY is defined as 50
+    first = this->inlineItems();
     n = 0;
-    capacity = CAPACITY;
+    allocated = InlineCapacity;
 }
 
-template <class value_type>
-Vector <value_type> :: Vector(std::initializer_list<value_type> l)
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+Vector <value_type, Instrumentation, Checking, InlineCapacity, Growth> :: Vector(std::initializer_list<value_type> l)
 {
-    n = l.size();
-    int i=0;
-    first = new value_type [CAPACITY + n];
-    for (auto it=l.begin(); it <= l.end(); it++)
-        {
-            first[i] = *it;
-            i++;
-        }
+    first = this->inlineItems();
+    n = 0;
+    allocated = InlineCapacity;
+    appendRange(l.begin(), l.end());
 }
 
-template <class value_type>
-Vector <value_type> :: Vector(const Vector &other)
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+Vector <value_type, Instrumentation, Checking, InlineCapacity, Growth> :: Vector(const Vector &other)
 {
-    first = new value_type [other.n];
-    memcpy(first,other.first,sizeof(value_type)*other.n);
-    n = other.n;
-    capacity = other.capacity;
+    first = this->inlineItems();
+    n = 0;
+    allocated = InlineCapacity;
+    appendRange(other.first, other.first + other.n);
 }
 
-template <class value_type>
-Vector <value_type> :: Vector( Vector &&other): Vector()
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+Vector <value_type, Instrumentation, Checking, InlineCapacity, Growth> :: Vector( Vector &&other): Vector()
 {
    swapVectors(*this, other);
 }
 
-template <class value_type>
-Vector <value_type> :: ~Vector()
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+Vector <value_type, Instrumentation, Checking, InlineCapacity, Growth> :: ~Vector()
 {
-    delete [] first;
+    destroyRange(first, n);
+    releaseItems(first);
 }
 
 
-template <class value_type>
-Vector<value_type>& Vector<value_type>:: operator=(Vector other)
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>& Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: operator=(Vector other)
 {
     swapVectors (*this, other);
     return *this;
 }
 
-template <class value_type>
-void Vector<value_type>:: swapVectors(Vector &x, Vector &y)
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: swapVectors(Vector &x, Vector &y)
+{
+   if (InlineCapacity == 0 || (!x.isInline() && !y.isInline()))
+   {
+       std::swap (x.allocated, y.allocated);
+       std::swap (x.n, y.n);
+       std::swap (x.first, y.first);
+       return;
+   }
+   // inline items cannot change owner by swapping pointers, they are moved
+   Vector tmp;
+   tmp.stealFrom(x);
+   x.stealFrom(y);
+   y.stealFrom(tmp);
+}
+
+// takes over other's items, leaving it empty; this has to be empty and inline
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: stealFrom(Vector &other)
+{
+    if (other.isInline()) moveItems(first, other.first, other.n);
+    else
+    {
+        first = other.first;
+        allocated = other.allocated;
+    }
+    n = other.n;
+    other.first = other.inlineItems();
+    other.allocated = InlineCapacity;
+    other.n = 0;
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+value_type* Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth> :: data()
+{
+    return first;
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+const value_type* Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth> :: data() const
+{
+    return first;
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+Span<value_type> Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth> :: asSpan()
 {
-   std::swap (x.capacity, y.capacity);
-   std::swap (x.n, y.n);
-   std::swap (x.first, y.first);
+    return Span<value_type>(first, n);
 }
 
-template <class value_type>
-bool Vector<value_type>:: isEmpty() const
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+Span<const value_type> Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth> :: asSpan() const
+{
+    return Span<const value_type>(first, n);
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+bool Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: isEmpty() const
 {
     if (n == 0) return true;
     return false;
 }
 
-template <class value_type>
-size_t Vector<value_type>:: getSize() const
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+size_t Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: getSize() const
 {
    return n;
 }
 
-template <class value_type>
-value_type& Vector<value_type>:: operator[](int i)
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+size_t Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: capacity() const
+{
+   return allocated;
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+value_type& Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: operator[](int i)
 {
     return first[i];
 }
 
-template <class value_type>
-void Vector<value_type>:: addMemory()
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+typename Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>::pointer Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: allocateItems(size_type count)
+{
+    this->countAllocation(count * sizeof(value_type));
+    if (allocated != 0) this->countReallocation(); // every caller replaces the current buffer
+    return allocateStorage<value_type>(count);
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: releaseItems(pointer p)
+{
+    if (p != this->inlineItems()) deallocateStorage(p);
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+bool Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: isInline() const
+{
+    return first == this->inlineItems();
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: moveItems(pointer to, pointer from, size_type count)
 {
-    pointer p;
-    p = new value_type [2*n];
-    capacity = 2*n;
-    memcpy(p,first,sizeof(value_type)*n);
-    delete[] first;
+    this->countMoved(count);
+    relocate(to, from, count);
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: reallocate(size_type newCapacity)
+{
+    pointer p = allocateItems(newCapacity);
+    moveItems(p, first, n);
+    releaseItems(first);
     first = p;
+    allocated = newCapacity;
 }
 
-template <class value_type>
-void Vector<value_type>:: append(const value_type& item)
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+size_t Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: grownCapacity() const
 {
-    if (n == capacity) addMemory();
-    first[n] = item;
-    n++;
+    size_type newCapacity = Growth::initialCapacity;
+    if (allocated != 0) newCapacity = static_cast<size_type>(allocated * Growth::factor);
+    if (newCapacity <= allocated) newCapacity = allocated + 1;
+    return newCapacity;
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: addMemory()
+{
+    reallocate(grownCapacity());
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: reserve(size_type newCapacity)
+{
+    if (newCapacity > allocated) reallocate(newCapacity);
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: shrinkToFit()
+{
+    if (n == allocated || isInline()) return;
+    if (n > InlineCapacity)
+    {
+        reallocate(n);
+        return;
+    }
+    pointer p = this->inlineItems(); // fits back into the inline buffer
+    moveItems(p, first, n);
+    releaseItems(first);
+    first = p;
+    allocated = InlineCapacity;
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: append(const value_type& item)
+{
+    emplaceAppend(item);
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: append(value_type&& item)
+{
+    emplaceAppend(std::move(item));
 }
 
-template <class value_type>
-void Vector<value_type>::prepend(const value_type& item)
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+template <typename... Args>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: emplaceAppend(Args&&... args)
 {
-    if (n == capacity) addMemory();
-    memmove(&first[1], first, sizeof(value_type)*n);
-    first[0] = item;
+    if (n == allocated)
+    {
+        // build the item in the new buffer first, args may refer to the old one
+        size_type newCapacity = grownCapacity();
+        pointer p = allocateItems(newCapacity);
+        try
+        {
+            new (&p[n]) value_type(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocateStorage(p);
+            throw;
+        }
+        moveItems(p, first, n);
+        releaseItems(first);
+        first = p;
+        allocated = newCapacity;
+    }
+    else new (&first[n]) value_type(std::forward<Args>(args)...);
     n++;
 }
 
-template <class value_type>
-void Vector<value_type>:: insert(const const_iterator& insertPosition, const value_type& item)
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>::prepend(const value_type& item)
+{
+    emplace(cbegin(), item);
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>::prepend(value_type&& item)
+{
+    emplace(cbegin(), std::move(item));
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+template <typename... Args>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: emplacePrepend(Args&&... args)
+{
+    emplace(cbegin(), std::forward<Args>(args)...);
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: insert(const const_iterator& insertPosition, const value_type& item)
+{
+    emplace(insertPosition, item);
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: insert(const const_iterator& insertPosition, value_type&& item)
 {
-    int i=insertPosition.getIndex();
-    if (n == capacity) addMemory();
-    memmove(&first[i+1],&first[i], sizeof(value_type)*(n-i));
-    first[i]=item;
+    emplace(insertPosition, std::move(item));
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+template <typename... Args>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: emplace(const const_iterator& position, Args&&... args)
+{
+    int i=position.getIndex();
+    value_type item(std::forward<Args>(args)...); // args may refer to an element about to move
+    if (n == allocated) addMemory();
+    moveItems(&first[i+1], &first[i], n-i);
+    new (&first[i]) value_type(std::move(item));
     n++;
 }
 
-template <class value_type>
-value_type Vector<value_type>::popLast()
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+template <typename InputIterator>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: appendRange(InputIterator firstItem, InputIterator lastItem)
+{
+    insert(cend(), firstItem, lastItem);
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+typename Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>::pointer Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: appendUninitialized(size_type count)
+{
+    static_assert(std::is_trivially_copyable<value_type>::value, "only items without constructors may be left unset");
+    reserve(n + count);
+    pointer items = first + n;
+    n += count;
+    return items;
+}
+
+// The range must not come from this vector.
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+template <typename InputIterator>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: insert(const const_iterator& insertPosition, InputIterator firstItem, InputIterator lastItem)
+{
+    using category = typename std::iterator_traits<InputIterator>::iterator_category;
+    size_type i = insertPosition.getIndex();
+    if (i > n) throw std::out_of_range("");
+    insertRange(i, firstItem, lastItem, category());
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: insert(const const_iterator& insertPosition, std::initializer_list<value_type> l)
+{
+    insert(insertPosition, l.begin(), l.end());
+}
+
+// single pass ranges cannot be measured up front, so they are buffered first
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+template <typename InputIterator>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: insertRange(size_type i, InputIterator firstItem, InputIterator lastItem, std::input_iterator_tag)
+{
+    Vector buffered;
+    for (; firstItem != lastItem; ++firstItem)
+        buffered.emplaceAppend(*firstItem);
+    insertRange(i, std::make_move_iterator(buffered.first),
+                std::make_move_iterator(buffered.first + buffered.n), std::forward_iterator_tag());
+}
+
+// grows at most once and shifts the tail at most once
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+template <typename ForwardIterator>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: insertRange(size_type i, ForwardIterator firstItem, ForwardIterator lastItem, std::forward_iterator_tag)
+{
+    size_type count = std::distance(firstItem, lastItem);
+    if (count == 0) return;
+    size_type constructed = 0;
+
+    if (n + count > allocated)
+    {
+        size_type newCapacity = grownCapacity();
+        if (newCapacity < n + count) newCapacity = n + count;
+        pointer p = allocateItems(newCapacity);
+        try
+        {
+            for (; firstItem != lastItem; ++firstItem, ++constructed)
+                new (&p[i + constructed]) value_type(*firstItem);
+        }
+        catch (...)
+        {
+            destroyRange(&p[i], constructed);
+            deallocateStorage(p);
+            throw;
+        }
+        moveItems(p, first, i);
+        moveItems(&p[i + count], &first[i], n - i);
+        releaseItems(first);
+        first = p;
+        allocated = newCapacity;
+    }
+    else
+    {
+        moveItems(&first[i + count], &first[i], n - i);
+        try
+        {
+            for (; firstItem != lastItem; ++firstItem, ++constructed)
+                new (&first[i + constructed]) value_type(*firstItem);
+        }
+        catch (...)
+        {
+            destroyRange(&first[i], constructed);
+            moveItems(&first[i], &first[i + count], n - i);
+            throw;
+        }
+    }
+    n += count;
+}
+
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+value_type Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>::popLast()
 {
     if (n==0) throw std::logic_error("vector is empty");
-    value_type item = first[n-1];
+    value_type item = std::move(first[n-1]);
+    first[n-1].~value_type();
     n--;
     return item;
 }
 
-template <class value_type>
-value_type Vector<value_type>::popFirst()
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+value_type Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>::popFirst()
 {
     if (n==0) throw std::logic_error("vector is empty");
-    value_type item = first[0];
-    memmove(first, &first[1], sizeof(value_type)*n);
+    value_type item = std::move(first[0]);
+    first[0].~value_type();
+    moveItems(first, &first[1], n-1);
     n--;
     return item;
 }
 
-template <class value_type>
-void Vector<value_type>::erase(const const_iterator& position)
+template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>::erase(const const_iterator& position)
 {
     int i = position.getIndex();
     if (i>=n || i<0 ) throw std::out_of_range("");
-    memmove(&first[i], &first[i+1], sizeof(value_type)*(n-i));
+    first[i].~value_type();
+    moveItems(&first[i], &first[i+1], n-i-1);
     n--;
 }
 
- template <class value_type>
- void Vector<value_type>:: erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+ template <class value_type, class Instrumentation, class Checking, std::size_t InlineCapacity, class Growth>
+ void Vector<value_type, Instrumentation, Checking, InlineCapacity, Growth>:: erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
  {
     int i = firstIncluded.getIndex();
     int j = lastExcluded.getIndex();
     if (n < (j-i)) throw std::out_of_range ("there is too little elements");
-    memmove(&first[i], &first[j], sizeof(value_type)*( n-j));
+    destroyRange(&first[i], j-i);
+    moveItems(&first[i], &first[j], n-j);
     n = n-(j-i);
  }
 
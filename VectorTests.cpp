@@ -1,7 +1,25 @@
 #include <Vector.h>
-
+#include <Sorting.h>
+#include <SimdAlgorithms.h>
+#include <ParallelAlgorithms.h>
+#include <CowVector.h>
+#include <MappedVector.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <atomic>
 #include <complex>
 #include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 #include <boost/test/test_tools.hpp>
@@ -10,12 +28,46 @@
 
 using TestedTypes = boost::mpl::list<std::int32_t, std::uint64_t, std::complex<std::int32_t>>;
 
+// iterator checks are tested too, so keep them on in release builds as well
+template <typename T>
+using LinearCollection = aisdi::Vector<T, aisdi::NoInstrumentation, aisdi::CheckedIterators>;
+
 template <typename T>
-using LinearCollection = aisdi::Vector<T>;
+using CowCollection = aisdi::CowVector<T, aisdi::NoInstrumentation, aisdi::CheckedIterators>;
 
 using std::begin;
 using std::end;
 
+// Its move may throw, so only the specialization below lets a Vector hold it.
+struct RelocatableItem
+{
+  static int moves;
+
+  int value;
+
+  RelocatableItem(int v) : value(v) {}
+  RelocatableItem(const RelocatableItem& other) = default;
+  RelocatableItem(RelocatableItem&& other) : value(other.value) { ++moves; }
+  RelocatableItem& operator=(const RelocatableItem& other) = default;
+  RelocatableItem& operator=(RelocatableItem&& other) = default;
+};
+
+int RelocatableItem::moves = 0;
+
+// Four slots first, then half as many again on every growth.
+struct SlowGrowth
+{
+  static constexpr std::size_t initialCapacity = 4;
+  static constexpr double factor = 1.5;
+};
+
+namespace aisdi
+{
+template <>
+struct is_trivially_relocatable<RelocatableItem> : std::true_type
+{};
+}
+
 BOOST_AUTO_TEST_SUITE(VectorTests)
 
 
@@ -716,6 +768,832 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(GivenNonEmptyCollection_WhenErasingRange_ThenSizeI
   BOOST_CHECK_EQUAL(collection.getSize(), 2);
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenEmptyCollection_WhenCreated_ThenNothingIsAllocated,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  LinearCollection<T> moved(std::move(collection));
+
+  BOOST_CHECK_EQUAL(collection.capacity(), 0);
+  BOOST_CHECK_EQUAL(moved.capacity(), 0);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenReserving_ThenCapacityGrowsAndItemsStay,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1, 2, 3 };
+
+  collection.reserve(1000);
+  collection.reserve(10);
+
+  BOOST_CHECK_EQUAL(collection.capacity(), 1000);
+  thenCollectionContainsValues(collection, { 1, 2, 3 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenShrinkingToFit_ThenCapacityEqualsSize,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection;
+  for (int i = 0; i < 100; ++i)
+    collection.append(i);
+  collection.erase(begin(collection) + 3, end(collection));
+
+  collection.shrinkToFit();
+
+  BOOST_CHECK_EQUAL(collection.capacity(), 3);
+  thenCollectionContainsValues(collection, { 0, 1, 2 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenGrowthPolicy_WhenAppending_ThenCapacityFollowsIt)
+{
+  aisdi::Vector<int, aisdi::NoInstrumentation, aisdi::CheckedIterators, 0, SlowGrowth> collection;
+  std::vector<std::size_t> capacities;
+
+  for (int i = 0; i < 10; ++i)
+  {
+    collection.append(i);
+    capacities.push_back(collection.capacity());
+  }
+
+  BOOST_CHECK((capacities == std::vector<std::size_t>{ 4, 4, 4, 4, 6, 6, 9, 9, 9, 13 }));
+  BOOST_CHECK_EQUAL(collection[9], 9);
+}
+
+// Every free function over Vector has to take a Vector of any growth policy.
+BOOST_AUTO_TEST_CASE(GivenGrowthPolicy_WhenRunningFreeFunctions_ThenTheyAcceptTheVector)
+{
+  using SlowVector = aisdi::Vector<std::int32_t, aisdi::NoInstrumentation, aisdi::CheckedIterators, 0, SlowGrowth>;
+  aisdi::ThreadPool pool(2);
+  SlowVector collection = { 3, 1, 2 };
+  SlowVector doubled = { 0, 0, 0 };
+
+  aisdi::sort(collection, std::less<std::int32_t>(), pool);
+  aisdi::parallelForEach(collection, [](std::int32_t& item) { item += 1; }, pool);
+  aisdi::parallelTransform(collection, doubled, [](std::int32_t item) { return 2 * item; }, pool);
+  aisdi::parallelFill(collection, 7, pool);
+
+  BOOST_CHECK_EQUAL(aisdi::parallelReduce(doubled, 0, [](int a, int b) { return a + b; }, pool), 18);
+  BOOST_CHECK_EQUAL(aisdi::count(collection, 7), 3);
+  BOOST_CHECK(aisdi::contains(doubled, 8));
+  BOOST_CHECK_EQUAL(aisdi::maximum(doubled), 8);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollectionOfStrings_WhenGrowingPastCapacity_ThenAllItemsArePreserved)
+{
+  LinearCollection<std::string> collection;
+  for (int i = 0; i < 500; ++i)
+    collection.append(std::string(40, 'a') + std::to_string(i));
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 500);
+  BOOST_CHECK_EQUAL(*begin(collection), std::string(40, 'a') + "0");
+  BOOST_CHECK_EQUAL(*(end(collection) - 1), std::string(40, 'a') + "499");
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollectionOfStrings_WhenShiftingItems_ThenOrderIsPreserved)
+{
+  LinearCollection<std::string> collection;
+  for (int i = 0; i < 60; ++i)
+    collection.prepend(std::to_string(i));
+  collection.insert(begin(collection) + 30, "middle");
+  collection.erase(begin(collection) + 10, begin(collection) + 20);
+  collection.erase(begin(collection));
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 50);
+  BOOST_CHECK_EQUAL(collection.popFirst(), "58");
+  BOOST_CHECK_EQUAL(*(begin(collection) + 18), "middle");
+  BOOST_CHECK_EQUAL(collection.popLast(), "0");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenInsertingRangeInMiddle_ThenItemsAreInOrder,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1, 2, 6 };
+  const std::vector<T> items = { 3, 4, 5 };
+
+  collection.insert(begin(collection) + 2, items.begin(), items.end());
+
+  thenCollectionContainsValues(collection, { 1, 2, 3, 4, 5, 6 });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenAppendingRange_ThenItemsAreLast,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1 };
+  const std::vector<T> items(100, T{7});
+
+  collection.appendRange(items.begin(), items.end());
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 101);
+  BOOST_CHECK_EQUAL(*begin(collection), T{1});
+  BOOST_CHECK_EQUAL(*(end(collection) - 1), T{7});
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenInsertingInitializerList_ThenItemsArePrepended,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 3 };
+
+  collection.insert(begin(collection), { 1, 2 });
+  collection.insert(end(collection), {});
+
+  thenCollectionContainsValues(collection, { 1, 2, 3 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenInsertingSinglePassRange_ThenItemsAreInserted)
+{
+  LinearCollection<int> collection = { 1, 5 };
+  std::istringstream stream("2 3 4");
+
+  collection.insert(begin(collection) + 1, std::istream_iterator<int>(stream), std::istream_iterator<int>());
+
+  thenCollectionContainsValues(collection, { 1, 2, 3, 4, 5 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenUninstrumentedCollection_WhenMeasuringSize_ThenNoCountersAreStored)
+{
+  BOOST_CHECK_EQUAL(sizeof(aisdi::Vector<int>), sizeof(int*) + 2 * sizeof(std::size_t));
+}
+
+BOOST_AUTO_TEST_CASE(GivenInstrumentedCollection_WhenGrowingAndShifting_ThenCountersAreUpdated)
+{
+  aisdi::Vector<int, aisdi::CountingInstrumentation> collection;
+  const auto globalBefore = aisdi::CountingInstrumentation::getGlobalCounters();
+
+  for (int i = 0; i < 100; ++i)
+    collection.append(i);
+  collection.prepend(-1);
+  for (auto it = collection.begin(); it != collection.end(); ++it) {}
+
+  const auto counters = collection.getInstrumentation().getCounters();
+  const auto globalAfter = aisdi::CountingInstrumentation::getGlobalCounters();
+  BOOST_CHECK_EQUAL(counters.allocations, 3);  // 50, 100, 200 slots
+  BOOST_CHECK_EQUAL(counters.reallocations, 2);
+  BOOST_CHECK_EQUAL(counters.bytesAllocated, 350 * sizeof(int));
+  BOOST_CHECK_EQUAL(counters.elementsMoved, 50 + 100 + 100);
+  BOOST_CHECK_EQUAL(counters.iteratorSteps, 101);
+  BOOST_CHECK_EQUAL(globalAfter.allocations - globalBefore.allocations, 3);
+}
+
+// Wraps a string and counts how often instances get copied or moved.
+struct CountedString
+{
+  static int copies;
+  static int moves;
+
+  std::string value;
+
+  CountedString(const char* text) : value(text) {}
+  CountedString(const CountedString& other) : value(other.value) { ++copies; }
+  CountedString(CountedString&& other) noexcept : value(std::move(other.value)) { ++moves; }
+
+  CountedString& operator=(const CountedString& other)
+  {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+
+  CountedString& operator=(CountedString&& other) noexcept
+  {
+    value = std::move(other.value);
+    ++moves;
+    return *this;
+  }
+
+  static void reset()
+  {
+    copies = 0;
+    moves = 0;
+  }
+};
+
+int CountedString::copies = 0;
+int CountedString::moves = 0;
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenMovingItemsThrough_ThenNothingIsCopied)
+{
+  LinearCollection<CountedString> collection;
+  CountedString::reset();
+
+  for (int i = 0; i < 100; ++i)
+  {
+    CountedString item("some string long enough to live on the heap");
+    collection.append(std::move(item));
+  }
+  CountedString item("prepended");
+  collection.prepend(std::move(item));
+  CountedString other("inserted");
+  collection.insert(begin(collection) + 50, std::move(other));
+  CountedString first = collection.popFirst();
+  CountedString last = collection.popLast();
+
+  BOOST_CHECK_EQUAL(CountedString::copies, 0);
+  BOOST_CHECK_EQUAL(first.value, "prepended");
+  BOOST_CHECK_EQUAL((*(begin(collection) + 49)).value, "inserted");
+  BOOST_CHECK_EQUAL(collection.getSize(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(GivenTriviallyRelocatableType_WhenItemsAreShifted_ThenTheyAreMovedAsBytes)
+{
+  LinearCollection<RelocatableItem> collection;
+  RelocatableItem::moves = 0;
+
+  for (int i = 0; i < 100; ++i)
+    collection.append(RelocatableItem(i));
+  const int movesIn = RelocatableItem::moves; // each appended temporary is moved in
+  collection.reserve(1000);
+  collection.erase(begin(collection) + 50);
+  collection.erase(begin(collection));
+  collection.shrinkToFit();
+
+  BOOST_CHECK_EQUAL(RelocatableItem::moves, movesIn);
+  BOOST_CHECK_EQUAL(collection.getSize(), 98);
+  BOOST_CHECK_EQUAL(collection[0].value, 1);
+  BOOST_CHECK_EQUAL(collection[48].value, 49);
+  BOOST_CHECK_EQUAL(collection[49].value, 51);
+  BOOST_CHECK_EQUAL(collection[97].value, 99);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCountTooLargeForMemory_WhenAllocatingStorage_ThenExceptionIsThrown)
+{
+  const std::size_t count = std::numeric_limits<std::size_t>::max() / sizeof(std::uint64_t) + 2;
+
+  BOOST_CHECK_THROW(aisdi::allocateStorage<std::uint64_t>(count), std::bad_array_new_length);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenEmplacing_ThenItemsAreBuiltInPlace)
+{
+  LinearCollection<CountedString> collection;
+  CountedString::reset();
+
+  collection.emplaceAppend("b");
+  collection.emplacePrepend("a");
+  collection.emplace(end(collection), "c");
+
+  BOOST_CHECK_EQUAL(CountedString::copies, 0);
+  BOOST_CHECK_EQUAL((*begin(collection)).value, "a");
+  BOOST_CHECK_EQUAL((*(begin(collection) + 1)).value, "b");
+  BOOST_CHECK_EQUAL((*(begin(collection) + 2)).value, "c");
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenAppendingCopy_ThenItemIsCopiedOnce)
+{
+  LinearCollection<CountedString> collection;
+  CountedString item("copied");
+  CountedString::reset();
+
+  collection.append(item);
+
+  BOOST_CHECK_EQUAL(CountedString::copies, 1);
+  BOOST_CHECK_EQUAL(item.value, "copied");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenMovingIteratorsByOffset_ThenTheyMoveAndCompare,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1, 2, 3, 4, 5 };
+  auto it = begin(collection);
+
+  it += 3;
+  BOOST_CHECK_EQUAL(*it, T{4});
+  it -= 2;
+  BOOST_CHECK_EQUAL(*it, T{2});
+  BOOST_CHECK_EQUAL(it[3], T{5});
+  BOOST_CHECK_EQUAL(end(collection) - it, 4);
+  BOOST_CHECK_EQUAL(*(2 + it), T{4});
+  BOOST_CHECK(begin(collection) < it);
+  BOOST_CHECK(it <= it);
+  BOOST_CHECK(end(collection) > it);
+  BOOST_CHECK(end(collection) >= end(collection));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenCollection_WhenMovingIteratorsOutOfRange_ThenOperationThrows,
+                              T,
+                              TestedTypes)
+{
+  LinearCollection<T> collection = { 1, 2, 3 };
+  auto it = begin(collection);
+
+  BOOST_CHECK_THROW(it += 4, std::out_of_range);
+  BOOST_CHECK_THROW(it -= 1, std::out_of_range);
+  BOOST_CHECK_THROW(it[3], std::out_of_range);
+  BOOST_CHECK_EQUAL(*it, T{1});
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenUsingStandardAlgorithms_ThenRandomAccessIsUsed)
+{
+  using Iterator = LinearCollection<int>::iterator;
+  static_assert(std::is_same<std::iterator_traits<Iterator>::iterator_category,
+                             std::random_access_iterator_tag>::value, "Vector iterators are random access");
+  LinearCollection<int> collection = { 5, 1, 4, 2, 3 };
+
+  std::sort(begin(collection), end(collection));
+
+  thenCollectionContainsValues(collection, { 1, 2, 3, 4, 5 });
+  BOOST_CHECK_EQUAL(std::lower_bound(begin(collection), end(collection), 4) - begin(collection), 3);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenViewingItsData_ThenItemsAreContiguous)
+{
+  LinearCollection<int> collection = { 1, 2, 3, 4 };
+  const LinearCollection<int>& constCollection = collection;
+  std::vector<int> copied(4);
+
+  collection.data()[0] = 10;
+  std::copy(constCollection.asSpan().begin(), constCollection.asSpan().end(), copied.begin());
+
+  BOOST_CHECK_EQUAL(&*(begin(collection) + 2), collection.data() + 2);
+  BOOST_CHECK_EQUAL(collection.asSpan().getSize(), 4);
+  BOOST_CHECK_EQUAL(collection.asSpan().subspan(1, 2)[1], 3);
+  BOOST_CHECK_THROW(collection.asSpan().subspan(3, 2), std::out_of_range);
+  BOOST_CHECK((copied == std::vector<int>{ 10, 2, 3, 4 }));
+}
+
+BOOST_AUTO_TEST_CASE(GivenInlineCapacity_WhenItemsFit_ThenNothingIsAllocated)
+{
+  aisdi::Vector<int, aisdi::CountingInstrumentation, aisdi::CheckedIterators, 4> collection = { 1, 2, 3, 4 };
+
+  BOOST_CHECK_EQUAL(collection.getInstrumentation().getCounters().allocations, 0);
+  BOOST_CHECK_EQUAL(collection.capacity(), 4);
+
+  collection.append(5);
+  BOOST_CHECK_EQUAL(collection.getInstrumentation().getCounters().allocations, 1);
+  BOOST_CHECK(collection.capacity() > 4);
+
+  collection.popLast();
+  collection.popFirst();
+  collection.shrinkToFit();
+  BOOST_CHECK_EQUAL(collection.capacity(), 4);
+  BOOST_CHECK_EQUAL(*begin(collection), 2);
+  BOOST_CHECK_EQUAL(*(end(collection) - 1), 4);
+}
+
+BOOST_AUTO_TEST_CASE(GivenSmallVectors_WhenSwappingInlineAndHeapItems_ThenItemsChangePlaces)
+{
+  aisdi::SmallVector<std::string, 2> small = { "a", "b" };
+  aisdi::SmallVector<std::string, 2> large = { "c", "d", "e" };
+
+  small.swapVectors(small, large);
+  aisdi::SmallVector<std::string, 2> moved(std::move(large));
+  aisdi::SmallVector<std::string, 2> copied = small;
+
+  BOOST_CHECK_EQUAL(small.getSize(), 3);
+  BOOST_CHECK_EQUAL(*(begin(small) + 2), "e");
+  BOOST_CHECK(large.isEmpty());
+  BOOST_CHECK_EQUAL(moved.getSize(), 2);
+  BOOST_CHECK_EQUAL(*(begin(moved) + 1), "b");
+  BOOST_CHECK_EQUAL(*begin(copied), "c");
+}
+
+BOOST_AUTO_TEST_CASE(GivenEmptyCollection_WhenAskingForExtremes_ThenExceptionIsThrown)
+{
+  LinearCollection<std::int32_t> collection;
+
+  BOOST_CHECK_THROW(aisdi::minimum(collection), std::logic_error);
+  BOOST_CHECK_THROW(aisdi::maximum(collection), std::logic_error);
+  BOOST_CHECK_EQUAL(aisdi::sum(collection), 0);
+  BOOST_CHECK(!aisdi::contains(collection, 0));
+}
+
+// few distinct values, so that searches hit; extremes of the type included
+template <typename T>
+T randomSimdValue(std::mt19937& random)
+{
+  const T values[] = { std::numeric_limits<T>::min(), std::numeric_limits<T>::max(),
+                       T(0), T(1), T(-1), T(7), T(42) };
+  return values[random() % 7];
+}
+
+template <>
+std::complex<std::int32_t> randomSimdValue(std::mt19937& random)
+{
+  return { randomSimdValue<std::int32_t>(random), randomSimdValue<std::int32_t>(random) };
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenAnySimdLevel_WhenSearchingAndSumming_ThenResultsMatchScalarOnes,
+                              T,
+                              TestedTypes)
+{
+  std::mt19937 random(16);
+  const aisdi::SimdLevel levels[] = { aisdi::SimdLevel::Sse2, aisdi::SimdLevel::Avx2, aisdi::SimdLevel::Avx512 };
+  for (int size = 0; size < 70; ++size)
+  {
+    LinearCollection<T> collection;
+    for (int i = 0; i < size; ++i) collection.append(randomSimdValue<T>(random));
+    const T needle = randomSimdValue<T>(random);
+    const auto scalar = aisdi::SimdLevel::Scalar;
+
+    for (auto level : levels)
+    {
+      BOOST_CHECK(aisdi::find(collection, needle, level) == aisdi::find(collection, needle, scalar));
+      BOOST_CHECK_EQUAL(aisdi::count(collection, needle, level), aisdi::count(collection, needle, scalar));
+      BOOST_CHECK_EQUAL(aisdi::contains(collection, needle, level), aisdi::contains(collection, needle, scalar));
+      BOOST_CHECK(aisdi::sum(collection, level) == aisdi::sum(collection, scalar));
+    }
+    BOOST_CHECK(aisdi::find(collection, needle, scalar) == std::find(begin(collection), end(collection), needle));
+    BOOST_CHECK_EQUAL(aisdi::count(collection, needle, scalar),
+                      std::count(begin(collection), end(collection), needle));
+  }
+}
+
+using OrderedTypes = boost::mpl::list<std::int32_t, std::uint64_t>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(GivenAnySimdLevel_WhenLookingForExtremes_ThenResultsMatchScalarOnes,
+                              T,
+                              OrderedTypes)
+{
+  std::mt19937 random(17);
+  const aisdi::SimdLevel levels[] = { aisdi::SimdLevel::Sse2, aisdi::SimdLevel::Avx2, aisdi::SimdLevel::Avx512 };
+  for (int size = 1; size < 70; ++size)
+  {
+    LinearCollection<T> collection;
+    for (int i = 0; i < size; ++i) collection.append(randomSimdValue<T>(random));
+
+    for (auto level : levels)
+    {
+      BOOST_CHECK_EQUAL(aisdi::minimum(collection, level), *std::min_element(begin(collection), end(collection)));
+      BOOST_CHECK_EQUAL(aisdi::maximum(collection, level), *std::max_element(begin(collection), end(collection)));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(GivenComplexItems_WhenSumming_ThenPartsAreSummedWithoutOverflow)
+{
+  const std::int32_t top = std::numeric_limits<std::int32_t>::max();
+  LinearCollection<std::complex<std::int32_t>> collection;
+  for (int i = 0; i < 9; ++i) collection.append({ top, -top });
+
+  BOOST_CHECK(aisdi::sum(collection) == std::complex<std::int64_t>(9ll * top, -9ll * top));
+}
+
+BOOST_AUTO_TEST_CASE(GivenLargeCollection_WhenRunningParallelAlgorithms_ThenResultsMatchSerialOnes)
+{
+  aisdi::ThreadPool pool(4);
+  for (int size : { 0, 1, 4095, 4096, 4097, 100003 })
+  {
+    LinearCollection<std::int32_t> collection;
+    for (int i = 0; i < size; ++i) collection.append(i);
+    LinearCollection<std::int64_t> squares;
+    for (int i = 0; i < size; ++i) squares.append(-1);
+
+    aisdi::parallelForEach(collection, [](std::int32_t& item) { item = 3 * item + 1; }, pool);
+    aisdi::parallelTransform(collection, squares, [](std::int32_t item) { return std::int64_t(item) * item; }, pool);
+    const auto total = aisdi::parallelReduce(collection, std::int64_t(5),
+                                             [](std::int64_t a, std::int64_t b) { return a + b; }, pool);
+
+    std::int64_t expectedTotal = 5;
+    for (int i = 0; i < size; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(collection[i], 3 * i + 1);
+      BOOST_REQUIRE_EQUAL(squares[i], std::int64_t(3 * i + 1) * (3 * i + 1));
+      expectedTotal += 3 * i + 1;
+    }
+    BOOST_CHECK_EQUAL(total, expectedTotal);
+
+    aisdi::parallelFill(collection, 7, pool);
+    BOOST_CHECK_EQUAL(std::count(begin(collection), end(collection), 7), size);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(GivenNonCommutativeOperation_WhenReducingInParallel_ThenItemOrderIsKept)
+{
+  aisdi::ThreadPool pool(3);
+  LinearCollection<std::string> collection;
+  std::string expected = ">";
+  for (int i = 0; i < 30000; ++i)
+  {
+    collection.append(std::string(1, char('a' + i % 26)));
+    expected += char('a' + i % 26);
+  }
+
+  auto joined = aisdi::parallelReduce(collection, std::string(">"),
+                                      [](std::string a, const std::string& b) { return a += b; }, pool);
+
+  BOOST_CHECK(joined == expected);
+}
+
+BOOST_AUTO_TEST_CASE(GivenThrowingFunction_WhenRunningInParallel_ThenExceptionReachesCaller)
+{
+  aisdi::ThreadPool pool(4);
+  LinearCollection<std::int32_t> collection;
+  for (int i = 0; i < 50000; ++i) collection.append(i);
+  LinearCollection<std::int32_t> shorter = { 1, 2 };
+
+  BOOST_CHECK_THROW(aisdi::parallelForEach(collection, [](std::int32_t& item) {
+    if (item == 40000) throw std::runtime_error("failed");
+  }, pool), std::runtime_error);
+  BOOST_CHECK_THROW(aisdi::parallelTransform(collection, shorter, [](std::int32_t item) { return item; }, pool),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenSorting_ThenEqualItemsKeepTheirOrder)
+{
+  std::mt19937 random(18);
+  aisdi::ThreadPool pool(4);
+  for (int size : { 0, 1, 2, 100, 32768, 100003 })
+  {
+    LinearCollection<std::pair<int, int>> collection;
+    std::vector<std::pair<int, int>> expected;
+    for (int i = 0; i < size; ++i)
+      expected.push_back({ int(random() % 1000), i });
+    collection.appendRange(expected.begin(), expected.end());
+
+    auto byKey = [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; };
+    aisdi::sort(collection, byKey, pool);
+    std::stable_sort(expected.begin(), expected.end(), byKey);
+
+    BOOST_CHECK(std::equal(begin(collection), end(collection), expected.begin(), expected.end()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenSortingWithDefaults_ThenItemsAscend)
+{
+  LinearCollection<int> collection = { 3, 1, 4, 2 };
+
+  aisdi::sort(collection);
+  thenCollectionContainsValues(collection, { 1, 2, 3, 4 });
+  aisdi::sort(collection, std::greater<int>());
+  thenCollectionContainsValues(collection, { 4, 3, 2, 1 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenThrowingComparison_WhenSorting_ThenNoItemIsLost)
+{
+  aisdi::ThreadPool pool(4);
+  for (int size : { 20, 100, 5000, 40000 })
+    for (int throwAt : { 1, 30, 300, size * 5, size * 12 })
+    {
+      LinearCollection<std::string> collection;
+      for (int i = 0; i < size; ++i) collection.append(std::to_string((i * 37) % size));
+      std::atomic<int> comparisons(0);
+
+      try
+      {
+        aisdi::sort(collection, [&](const std::string& a, const std::string& b) {
+          if (++comparisons == throwAt) throw std::runtime_error("failed");
+          return a < b;
+        }, pool);
+      }
+      catch (const std::runtime_error&)
+      {}
+
+      std::vector<int> items;
+      for (const auto& item : collection) items.push_back(std::stoi(item));
+      std::sort(items.begin(), items.end());
+      BOOST_REQUIRE_EQUAL(items.size(), size);
+      for (int i = 0; i < size; ++i) BOOST_REQUIRE_EQUAL(items[i], i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GivenCowCollection_WhenCopying_ThenItemsAreSharedUntilChanged)
+{
+  CowCollection<int> collection = { 1, 2, 3 };
+  const CowCollection<int> snapshot = collection;
+
+  BOOST_CHECK(collection.isShared());
+  BOOST_CHECK_EQUAL(snapshot.data(), static_cast<const CowCollection<int>&>(collection).data());
+
+  collection.append(4);
+  BOOST_CHECK(!collection.isShared());
+  BOOST_CHECK(!snapshot.isShared());
+  thenCollectionContainsValues(snapshot.items(), { 1, 2, 3 });
+  thenCollectionContainsValues(collection.items(), { 1, 2, 3, 4 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenCowCollection_WhenWritingThroughIndex_ThenOnlyThatCopyChanges)
+{
+  CowCollection<std::string> collection = { "a", "b" };
+  CowCollection<std::string> snapshot = collection;
+  const auto& reader = snapshot;
+
+  BOOST_CHECK_EQUAL(reader[1], "b");
+  BOOST_CHECK(snapshot.isShared());
+  collection[1] = "c";
+  BOOST_CHECK_EQUAL(collection[1], "c");
+  BOOST_CHECK_EQUAL(reader[1], "b");
+}
+
+BOOST_AUTO_TEST_CASE(GivenMutableReferenceHandedOut_WhenCopyingAndWritingThroughIt_ThenCopyIsUnchanged)
+{
+  CowCollection<int> collection = { 1, 2, 3 };
+  int& item = collection[0];
+  const auto snapshot = collection;
+  item = 9;
+
+  BOOST_CHECK_EQUAL(snapshot[0], 1);
+  BOOST_CHECK(!collection.isShared());
+
+  auto position = collection.begin();
+  const auto other = collection;
+  *position = 8;
+
+  BOOST_CHECK_EQUAL(other[0], 9);
+  BOOST_CHECK_EQUAL(snapshot[0], 1);
+  thenCollectionContainsValues(collection.items(), { 8, 2, 3 });
+}
+
+BOOST_AUTO_TEST_CASE(GivenCowCollection_WhenWritingThroughSet_ThenLaterCopiesAreStillShared)
+{
+  CowCollection<int> collection = { 1, 2, 3 };
+  const auto snapshot = collection;
+
+  collection.set(0, 9);
+  const auto other = collection;
+
+  BOOST_CHECK(collection.isShared());
+  BOOST_CHECK_EQUAL(snapshot[0], 1);
+  BOOST_CHECK_EQUAL(other[0], 9);
+}
+
+BOOST_AUTO_TEST_CASE(GivenSharedCowCollection_WhenInsertingAndErasing_ThenPositionsAreKept)
+{
+  CowCollection<int> collection = { 1, 2, 3, 4 };
+  CowCollection<int> snapshot = collection;
+
+  collection.insert(collection.cbegin() + 1, 9);
+  CowCollection<int> second = collection;
+  collection.erase(collection.cbegin() + 2, collection.cend());
+  second.erase(second.cbegin());
+
+  thenCollectionContainsValues(collection.items(), { 1, 9 });
+  thenCollectionContainsValues(second.items(), { 9, 2, 3, 4 });
+  thenCollectionContainsValues(snapshot.items(), { 1, 2, 3, 4 });
+}
+
+// Meant to be run under ThreadSanitizer too, which checks the count.
+BOOST_AUTO_TEST_CASE(GivenCowCollection_WhenSnapshotsAreReadOnOtherThreads_ThenEachSeesItsOwnVersion)
+{
+  CowCollection<int> collection;
+  std::vector<std::thread> readers;
+  std::vector<int> sums(8, -1);
+  for (int version = 0; version < 8; ++version)
+  {
+    collection.append(version);
+    readers.emplace_back([snapshot = collection, &sums, version] {
+      int sum = 0;
+      for (int item : snapshot) sum += item;
+      sums[version] = sum;
+    });
+  }
+  for (auto& reader : readers) reader.join();
+
+  for (int version = 0; version < 8; ++version)
+    BOOST_CHECK_EQUAL(sums[version], version * (version + 1) / 2);
+  BOOST_CHECK(!collection.isShared());
+}
+
+// A file in /tmp, removed again at the end of the test.
+struct TemporaryFile
+{
+  std::string path;
+
+  explicit TemporaryFile(const char* name)
+    : path(std::string("/tmp/aisdi-") + name + "-" + std::to_string(getpid()))
+  {
+    std::remove(path.c_str());
+  }
+
+  ~TemporaryFile()
+  {
+    std::remove(path.c_str());
+  }
+};
+
+template <typename T>
+using MappedCollection = aisdi::MappedVector<T, aisdi::CheckedIterators>;
+
+BOOST_AUTO_TEST_CASE(GivenMappedCollection_WhenReopened_ThenItemsAreStillThere)
+{
+  TemporaryFile file("reopen");
+  {
+    MappedCollection<std::uint64_t> collection(file.path);
+    BOOST_CHECK(collection.isEmpty());
+    for (std::uint64_t i = 0; i < 10000; ++i)
+      collection.append(i * 3);
+    collection.popLast();
+    collection.sync();
+  }
+
+  MappedCollection<std::uint64_t> collection(file.path);
+  BOOST_CHECK_EQUAL(collection.getSize(), 9999);
+  BOOST_CHECK_EQUAL(collection[9998], 9998 * 3);
+  std::uint64_t expected = 0;
+  for (std::uint64_t item : collection)
+  {
+    BOOST_CHECK_EQUAL(item, expected);
+    expected += 3;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(GivenMappedCollection_WhenItGrows_ThenIteratorsStayValid)
+{
+  TemporaryFile file("grow");
+  MappedCollection<std::int32_t> collection(file.path);
+  collection.append(1);
+  auto first = collection.begin();
+  const std::size_t capacity = collection.capacity();
+
+  for (std::size_t i = 0; i < capacity; ++i)
+    collection.append(2);
+  *first = 7;
+  collection.advise(MappedCollection<std::int32_t>::Access::Sequential);
+
+  BOOST_CHECK(collection.capacity() > capacity);
+  BOOST_CHECK_EQUAL(collection[0], 7);
+  BOOST_CHECK_EQUAL(std::count(collection.cbegin(), collection.cend(), 2), capacity);
+  BOOST_CHECK_THROW(*collection.end(), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(GivenFileWithHeaderOnly_WhenAppending_ThenItGrows)
+{
+  TemporaryFile file("header");
+  {
+    MappedCollection<std::int32_t> collection(file.path);
+  }
+  BOOST_REQUIRE_EQUAL(truncate(file.path.c_str(), 64), 0);
+
+  MappedCollection<std::int32_t> collection(file.path);
+  BOOST_CHECK_EQUAL(collection.capacity(), 0);
+  collection.append(5);
+  collection.append(6);
+
+  BOOST_CHECK(collection.capacity() >= 2);
+  BOOST_CHECK_EQUAL(collection.getSize(), 2);
+  BOOST_CHECK_EQUAL(collection[0], 5);
+  BOOST_CHECK_EQUAL(collection[1], 6);
+}
+
+BOOST_AUTO_TEST_CASE(GivenFileOfOtherItems_WhenMapping_ThenExceptionIsThrown)
+{
+  TemporaryFile file("mismatch");
+  {
+    MappedCollection<std::int32_t> collection(file.path);
+    collection.append(1);
+  }
+
+  BOOST_CHECK_THROW(MappedCollection<std::uint64_t> collection(file.path), std::runtime_error);
+  BOOST_CHECK_THROW(MappedCollection<std::int32_t> collection("/nonexistent/directory/file"), std::system_error);
+}
+
+BOOST_AUTO_TEST_CASE(GivenCollection_WhenWrittenAndReadBack_ThenItemsAreAppended)
+{
+  std::FILE* stream = std::tmpfile();
+  LinearCollection<std::uint64_t> collection;
+  for (std::uint64_t i = 0; i < 100000; ++i) collection.append(i * i);
+  aisdi::writeBinary(fileno(stream), collection);
+  aisdi::writeBinary(fileno(stream), LinearCollection<std::uint64_t>());
+  std::rewind(stream);
+
+  LinearCollection<std::uint64_t> read = { 7 };
+  aisdi::readBinary(fileno(stream), read);
+  aisdi::readBinary(fileno(stream), read);
+  std::fclose(stream);
+
+  BOOST_CHECK_EQUAL(read.getSize(), 100001);
+  BOOST_CHECK_EQUAL(read[0], 7);
+  BOOST_CHECK(std::equal(collection.begin(), collection.end(), read.begin() + 1));
+}
+
+BOOST_AUTO_TEST_CASE(GivenHeaderWithHugeCount_WhenReading_ThenExceptionIsThrownAndNothingIsAppended)
+{
+  std::FILE* stream = std::tmpfile();
+  aisdi::writeBinary(fileno(stream), LinearCollection<std::uint64_t>{ 1 });
+  // count = 2^61 + 1 makes count * 8 wrap around to 8 bytes
+  for (std::uint64_t count : { (std::uint64_t(1) << 61) + 1, std::uint64_t(2) })
+  {
+    BOOST_CHECK_EQUAL(pwrite(fileno(stream), &count, sizeof(count), 24), ssize_t(sizeof(count)));
+    std::rewind(stream);
+    LinearCollection<std::uint64_t> read = { 9 };
+    BOOST_CHECK_THROW(aisdi::readBinary(fileno(stream), read), std::runtime_error);
+    BOOST_CHECK_EQUAL(read.getSize(), 1);
+  }
+  std::fclose(stream);
+}
+
+BOOST_AUTO_TEST_CASE(GivenStreamOfOtherItemsOrCutShort_WhenReading_ThenExceptionIsThrownAndNothingIsAppended)
+{
+  std::FILE* stream = std::tmpfile();
+  aisdi::writeBinary(fileno(stream), LinearCollection<std::int32_t>{ 1, 2, 3 });
+  std::rewind(stream);
+  LinearCollection<std::uint64_t> wide;
+  BOOST_CHECK_THROW(aisdi::readBinary(fileno(stream), wide), std::runtime_error);
+
+  BOOST_CHECK_EQUAL(ftruncate(fileno(stream), 32 + 2 * sizeof(std::int32_t)), 0);
+  std::rewind(stream);
+  LinearCollection<std::int32_t> cut = { 9 };
+  BOOST_CHECK_THROW(aisdi::readBinary(fileno(stream), cut), std::runtime_error);
+  std::fclose(stream);
+
+  BOOST_CHECK(wide.isEmpty());
+  thenCollectionContainsValues(cut, { 9 });
+}
+
 // ConstIterator is tested via Iterator methods.
 // If Iterator methods are to be changed, then new ConstIterator tests are required.
 